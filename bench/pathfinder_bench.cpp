@@ -0,0 +1,322 @@
+// Microbenchmark for the Pathfinder engines and the BitBoardSearch kernels.
+//
+// Times every engine (or the one picked with --engine) over a matrix of grid
+// sizes, random obstacle densities, snake lengths and goal placements
+// (straight across the board vs. across the wrap-around edge), and reports
+// ns/call, nodes expanded and heap allocations per call. Every engine should
+// find a shortest path, so a path length that differs from the first
+// engine's in the same scenario is flagged, and the run fails. A second
+// table times whole-board flood fills (layered BFS steps and scanline
+// sweeps) and BFS distances on the bit-packed grid, scalar and AVX2. The two
+// fills must agree on every board, including small random wrap-around ones
+// checked up front, or the benchmark aborts.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "pathfinder.h"
+#include "bit_grid.h"
+#include "snake_base.h"
+
+namespace {
+
+std::size_t g_allocations = 0;
+
+}  // namespace
+
+void *operator new(std::size_t size) {
+  g_allocations++;
+  if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+  g_allocations++;
+  if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+// Static obstacle built directly on SnakeBase's occupancy grid, so the
+// pathfinder sees it through the same SnakeCell() path as real snakes.
+class BenchObstacle : public SnakeBase {
+ public:
+  BenchObstacle(int grid_width, int grid_height) : SnakeBase(grid_width, grid_height) {}
+
+  void Update() override {}
+
+  // Covers roughly |density| of the board with randomly scattered cells.
+  void Scatter(std::mt19937 &rng, double density) {
+    std::bernoulli_distribution coin(density);
+    for (auto &count : occupancy) {
+      if (coin(rng)) count++;
+    }
+  }
+
+  // Lays a snake body of |length| cells as a random walk from the head.
+  void LaySnake(std::mt19937 &rng, int length) {
+    static constexpr int kOffsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    SDL_Point cell = head;
+    for (int laid = 1; laid < length; ++laid) {
+      int first = rng() % 4;
+      bool moved = false;
+      for (int i = 0; i < 4 && !moved; ++i) {
+        const int *offset = kOffsets[(first + i) % 4];
+        SDL_Point next{(cell.x + offset[0] + grid_width) % grid_width,
+                       (cell.y + offset[1] + grid_height) % grid_height};
+        if (occupancy[CellIndex(next.x, next.y)] == 0) {
+          body.push_back(next);
+          occupancy[CellIndex(next.x, next.y)]++;
+          cell = next;
+          moved = true;
+        }
+      }
+      if (!moved) break;
+    }
+  }
+
+  void Clear(const SDL_Point &cell) { occupancy[CellIndex(cell.x, cell.y)] = 0; }
+};
+
+struct Scenario {
+  PathfinderEngine engine;
+  int grid;
+  double density;
+  int snake_length;
+  bool wrap_goal;
+};
+
+struct Result {
+  double ns_per_call;
+  double expanded;
+  double allocations;
+  std::size_t path_length;
+};
+
+Result RunScenario(const Scenario &scenario, double min_seconds) {
+  const int size = scenario.grid;
+  std::mt19937 rng(size * 7919 + static_cast<int>(scenario.density * 100) +
+                   scenario.snake_length);
+
+  BenchObstacle scattered(size, size);
+  scattered.Scatter(rng, scenario.density);
+  BenchObstacle snake(size, size);
+  snake.LaySnake(rng, scenario.snake_length);
+
+  // Interior goals are closer directly; wrap goals are closer across the edge.
+  SDL_Point start, goal;
+  if (scenario.wrap_goal) {
+    start = {size / 16, size / 2 + 1};
+    goal = {size - 1 - size / 16, size / 2 + 1};
+  } else {
+    start = {size / 4, size / 4};
+    goal = {size * 5 / 8, size * 5 / 8};
+  }
+  for (auto *obstacle : {&scattered, &snake}) {
+    obstacle->Clear(start);
+    obstacle->Clear(goal);
+  }
+
+  // The blocked grid every engine reads, as Game builds it from the snakes.
+  std::vector<std::uint8_t> blocked(static_cast<std::size_t>(size) * size);
+  for (std::size_t cell = 0; cell < blocked.size(); ++cell) {
+    blocked[cell] = scattered.GetOccupancy()[cell] || snake.GetOccupancy()[cell];
+  }
+  std::unique_ptr<Pathfinder> pathfinder = MakePathfinder(scenario.engine, size, size);
+  std::vector<SDL_Point> path;
+  pathfinder->FindPath(start, goal, blocked, path);  // Warm-up sizes buffers.
+
+  std::size_t allocations_before = g_allocations;
+  long long expanded = 0;
+  int calls = 0;
+  auto begin = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed{0};
+  do {
+    pathfinder->FindPath(start, goal, blocked, path);
+    expanded += pathfinder->GetLastExpanded();
+    calls++;
+    elapsed = std::chrono::steady_clock::now() - begin;
+  } while (elapsed.count() < min_seconds || calls < 3);
+
+  return {elapsed.count() * 1e9 / calls, static_cast<double>(expanded) / calls,
+          static_cast<double>(g_allocations - allocations_before) / calls, path.size()};
+}
+
+// Board whose cells are each blocked with probability |density|, except
+// |start|, which is always free.
+BitGrid RandomBoard(std::mt19937 &rng, int width, int height, double density,
+                    const SDL_Point &start) {
+  std::bernoulli_distribution coin(density);
+  BitGrid free(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      if (!coin(rng)) free.Set(x, y);
+    }
+  }
+  free.Set(start.x, start.y);
+  return free;
+}
+
+// The scanline flood fill must reach exactly the cells the layered one
+// does. Small random boards, with starts on the first and last rows where
+// the sweeps meet the wrap-around edge; returns false on the first mismatch.
+bool CheckFloodFill(bool simd) {
+  std::mt19937 rng(12345);
+  for (int board = 0; board < 3000; ++board) {
+    int width = 2 + rng() % 150;
+    int height = 2 + rng() % 40;
+    int row = board % 3 == 0 ? 0 : board % 3 == 1 ? height - 1 : rng() % height;
+    SDL_Point start{static_cast<int>(rng() % width), row};
+    BitGrid free = RandomBoard(rng, width, height, (rng() % 50) / 100.0, start);
+    BitBoardSearch search(width, height);
+    search.SetSimd(simd);
+    std::size_t filled = search.FloodFill(free, start);
+    int area = search.ReachableArea(free, start, width * height);
+    if (filled != static_cast<std::size_t>(area)) {
+      std::fprintf(stderr, "FloodFill reached %zu cells, ReachableArea %d (%dx%d from %d,%d)\n",
+                   filled, area, width, height, start.x, start.y);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct FloodResult {
+  double fill_ns;
+  double sweep_ns;
+  double distance_ns;
+  int area;
+  int distance;
+  // FloodFill reached the same cells as ReachableArea.
+  bool fill_matches;
+};
+
+// Flood fill of the whole reachable area and BFS distance across the board.
+FloodResult RunFloodScenario(int size, double density, bool simd, double min_seconds) {
+  std::mt19937 rng(size * 104729 + static_cast<int>(density * 100));
+  SDL_Point start{size / 4, size / 4};
+  SDL_Point goal{size * 5 / 8, size * 5 / 8};
+  BitGrid free = RandomBoard(rng, size, size, density, start);
+  free.Set(goal.x, goal.y);
+
+  BitBoardSearch search(size, size);
+  search.SetSimd(simd);
+  FloodResult result{};
+  result.area = search.ReachableArea(free, start, size * size);  // Warm-up.
+  result.distance = search.Distance(free, start, goal);
+  result.fill_matches = search.FloodFill(free, start) == static_cast<std::size_t>(result.area);
+  if (!result.fill_matches) {
+    return result;  // Not worth timing.
+  }
+
+  auto time_calls = [min_seconds](auto &&call) {
+    int calls = 0;
+    auto begin = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{0};
+    do {
+      call();
+      calls++;
+      elapsed = std::chrono::steady_clock::now() - begin;
+    } while (elapsed.count() < min_seconds || calls < 3);
+    return elapsed.count() * 1e9 / calls;
+  };
+  result.fill_ns = time_calls([&] { search.ReachableArea(free, start, size * size); });
+  result.sweep_ns = time_calls([&] { search.FloodFill(free, start); });
+  result.distance_ns = time_calls([&] { search.Distance(free, start, goal); });
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  int max_grid = 1024;
+  double min_seconds = 0.1;
+  std::vector<PathfinderEngine> engines{PathfinderEngine::kAStar, PathfinderEngine::kBfs,
+                                        PathfinderEngine::kBidirectional,
+                                        PathfinderEngine::kJumpPoint};
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--max-grid") == 0 && i + 1 < argc) {
+      max_grid = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+      min_seconds = std::atof(argv[++i]) / 1000.0;
+    } else if (std::strcmp(argv[i], "--engine") == 0 && i + 1 < argc &&
+               ParsePathfinder(argv[i + 1], engines[0])) {
+      engines.resize(1);
+      ++i;
+    } else {
+      std::printf(
+          "Usage: pathfinder_bench [--max-grid N] [--min-time-ms N] "
+          "[--engine astar|bfs|bidir|jps]\n");
+      return 1;
+    }
+  }
+
+  std::printf("%-10s %8s %8s %6s %6s %14s %12s %10s %8s\n", "grid", "density", "snake",
+              "goal", "engine", "ns/call", "expanded", "allocs", "path");
+  int mismatches = 0;
+  for (int grid = 32; grid <= max_grid; grid *= 2) {
+    for (double density : {0.0, 0.1, 0.3}) {
+      for (int snake_length : {1, grid * 4}) {
+        for (bool wrap_goal : {false, true}) {
+          std::size_t first_length = 0;
+          for (PathfinderEngine engine : engines) {
+            Scenario scenario{engine, grid, density, snake_length, wrap_goal};
+            Result result = RunScenario(scenario, min_seconds);
+            if (engine == engines[0]) first_length = result.path_length;
+            bool mismatch = result.path_length != first_length;
+            mismatches += mismatch;
+            char label[32];
+            std::snprintf(label, sizeof(label), "%dx%d", grid, grid);
+            std::printf("%-10s %8.2f %8d %6s %6s %14.0f %12.0f %10.2f %8zu%s\n", label, density,
+                        snake_length, wrap_goal ? "wrap" : "direct", PathfinderName(engine),
+                        result.ns_per_call, result.expanded, result.allocations,
+                        result.path_length, mismatch ? "  <- differs" : "");
+          }
+        }
+      }
+    }
+  }
+  if (mismatches > 0) {
+    std::fprintf(stderr, "%d path lengths differ from %s's\n", mismatches,
+                 PathfinderName(engines[0]));
+  }
+
+  std::printf("\n%-10s %8s %6s %14s %12s %14s %10s %8s\n", "grid", "density", "kernel",
+              "fill ns", "sweep ns", "distance ns", "area", "dist");
+  for (bool simd : {false, true}) {
+    if (simd && !BitBoardSearch::CpuHasAvx2()) continue;
+    if (!CheckFloodFill(simd)) {
+      return 1;
+    }
+  }
+  for (int grid = 256; grid <= max_grid * 2; grid *= 2) {
+    for (double density : {0.0, 0.1, 0.3}) {
+      for (bool simd : {false, true}) {
+        if (simd && !BitBoardSearch::CpuHasAvx2()) continue;
+        FloodResult result = RunFloodScenario(grid, density, simd, min_seconds);
+        if (!result.fill_matches) {
+          std::fprintf(stderr, "FloodFill and ReachableArea disagree on %dx%d at %.2f\n", grid,
+                       grid, density);
+          return 1;
+        }
+        char label[32];
+        std::snprintf(label, sizeof(label), "%dx%d", grid, grid);
+        std::printf("%-10s %8.2f %6s %14.0f %12.0f %14.0f %10d %8d\n", label, density,
+                    simd ? "avx2" : "scalar", result.fill_ns, result.sweep_ns, result.distance_ns,
+                    result.area, result.distance);
+      }
+    }
+  }
+  return mismatches > 0 ? 1 : 0;
+}
@@ -3,47 +3,70 @@
 #include <algorithm>
 
 AISnake::AISnake(int grid_width, int grid_height)
+    : AISnake(grid_width, grid_height, std::random_device{}()) {}
+
+AISnake::AISnake(int grid_width, int grid_height, std::uint32_t seed)
+    : AISnake(grid_width, grid_height, seed, grid_width / 4, grid_height / 4) {}
+
+AISnake::AISnake(int grid_width, int grid_height, std::uint32_t seed, int spawn_x,
+                 int spawn_y)
     : SnakeBase(grid_width, grid_height),
-      pathfinder_(std::make_unique<AStarPathfinder>(grid_width, grid_height)),
+      pathfinder_(MakePathfinder(PathfinderEngine::kAStar, grid_width, grid_height)),
       target_{0, 0},
       path_index_(0),
       update_counter_(0),
       movement_delay_counter_(0),
-      rng_(std::random_device{}()),
+      rng_(seed),
       fairness_dist_(1, 100) {
-  head_x = grid_width / 4.0f;
-  head_y = grid_height / 4.0f;
-  speed = 0.1;
+  PlaceHead(spawn_x, spawn_y);
 }
 
 void AISnake::Update() {
-  SDL_Point prev_cell{
-      static_cast<int>(head_x),
-      static_cast<int>(head_y)};
+  SDL_Point prev_cell = head;
   
   update_counter_++;
+
+  if (mcts_) {
+    UpdateMcts(prev_cell);
+    return;
+  }
   
   // Slow down the AI snake, otherwise its nearly impossible to win
   if (!ShouldMoveThisFrame()) {
     return;
   }
   
-  if (ShouldRecalculatePath()) {
-    UpdatePath();
+  if (distance_field_) {
+    UpdateFieldPath();
+  } else if (incremental_) {
+    UpdateIncrementalPath();
+  } else if (ShouldRecalculatePath()) {
+    if (external_planning_) {
+      replan_requested_ = true;
+    } else {
+      UpdatePath();
+    }
   }
   
   // Occasionally make suboptimal moves for fairness
   if (!ShouldMakeMistake()) {
+    AvoidTraps();
     FollowPath();
   }
-  UpdateHead();
-  
-  SDL_Point current_cell{
-      static_cast<int>(head_x),
-      static_cast<int>(head_y)};
+  if (UpdateHead()) {
+    UpdateBody(head, prev_cell);
+  }
+}
 
-  if (current_cell.x != prev_cell.x || current_cell.y != prev_cell.y) {
-    UpdateBody(current_cell, prev_cell);
+// One search per cell: the direction only matters once the head reaches
+// the next one.
+void AISnake::UpdateMcts(SDL_Point prev_cell) {
+  if (board_ && (head.x != decided_cell_.x || head.y != decided_cell_.y)) {
+    decided_cell_ = head;
+    ChangeDirection(mcts_->Decide(*board_, *this, opponent_, target_), Opposite(direction));
+  }
+  if (UpdateHead()) {
+    UpdateBody(head, prev_cell);
   }
 }
 
@@ -51,13 +74,86 @@ void AISnake::SetTarget(const SDL_Point& target) {
   target_ = target;
 }
 
-void AISnake::SetObstacles(const std::vector<const SnakeBase*>& obstacles) {
-  obstacles_ = obstacles;
+void AISnake::SetPlanner(AIPlanner planner) {
+  if (planner == AIPlanner::kIncremental) {
+    incremental_ = std::make_unique<DStarLite>(grid_width, grid_height);
+  } else {
+    incremental_.reset();
+  }
+}
+
+void AISnake::SetPathfinder(PathfinderEngine engine) {
+  pathfinder_ = MakePathfinder(engine, grid_width, grid_height);
+}
+
+void AISnake::OnCellChanged(int x, int y, bool blocked) {
+  if (incremental_) {
+    incremental_->SetCellBlocked(x, y, blocked);
+  }
+}
+
+bool AISnake::TakeReplanRequest() {
+  bool requested = replan_requested_;
+  replan_requested_ = false;
+  return requested;
+}
+
+void AISnake::AdoptPath(const std::vector<SDL_Point>& path) {
+  SDL_Point current_pos = head;
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    if (path[i].x == current_pos.x && path[i].y == current_pos.y) {
+      current_path_ = path;
+      path_index_ = i;
+      return;
+    }
+  }
+  current_path_.clear();
+  path_index_ = 0;
 }
 
 void AISnake::UpdatePath() {
-  SDL_Point current_pos{static_cast<int>(head_x), static_cast<int>(head_y)};
-  current_path_ = pathfinder_->FindPath(current_pos, target_, obstacles_);
+  SDL_Point current_pos = head;
+  if (board_) {
+    pathfinder_->FindPath(current_pos, target_, *board_, current_path_);
+  } else {
+    current_path_.clear();
+  }
+  path_index_ = 0;
+}
+
+// Replans on every move. Only a new target restarts the search; otherwise
+// D* Lite repairs the previous one from the changes fed in by OnCellChanged.
+void AISnake::UpdateIncrementalPath() {
+  SDL_Point current_pos = head;
+  if (!board_) {
+    current_path_.clear();
+    return;
+  }
+  if (!incremental_->HasGoal(target_)) {
+    incremental_->Reset(current_pos, target_, *board_);
+  } else {
+    incremental_->MoveStart(current_pos);
+  }
+
+  SDL_Point next;
+  if (incremental_->ComputePath() && incremental_->NextStep(next)) {
+    current_path_.assign({current_pos, next});
+  } else {
+    current_path_.clear();
+  }
+  path_index_ = 0;
+}
+
+// The shared field already holds every cell's distance to the food, so the
+// next step is the closest of the four neighbours.
+void AISnake::UpdateFieldPath() {
+  SDL_Point current_pos = head;
+  SDL_Point next;
+  if (distance_field_->HasGoal(target_) && distance_field_->NextStep(current_pos, next)) {
+    current_path_.assign({current_pos, next});
+  } else {
+    current_path_.clear();
+  }
   path_index_ = 0;
 }
 
@@ -66,7 +162,7 @@ void AISnake::FollowPath() {
     return;
   }
   
-  SDL_Point current_pos{static_cast<int>(head_x), static_cast<int>(head_y)};
+  SDL_Point current_pos = head;
   SDL_Point next_point = current_path_[path_index_];
   
   if (current_pos.x == next_point.x && current_pos.y == next_point.y) {
@@ -79,21 +175,63 @@ void AISnake::FollowPath() {
   }
   
   Direction new_direction = GetDirectionToPoint(next_point);
-  
-  Direction opposite;
-  switch (direction) {
-    case Direction::kUp: opposite = Direction::kDown; break;
-    case Direction::kDown: opposite = Direction::kUp; break;
-    case Direction::kLeft: opposite = Direction::kRight; break;
-    case Direction::kRight: opposite = Direction::kLeft; break;
+  ChangeDirection(new_direction, Opposite(direction));
+}
+
+// Checks that the cell the path leads into still has room for the whole
+// body, using word-wide flood fills that stop as soon as enough room is found.
+void AISnake::AvoidTraps() {
+  if (!free_cells_ || !space_search_) {
+    return;
   }
-  
-  ChangeDirection(new_direction, opposite);
+
+  int needed = size + 1;
+  SDL_Point next;
+  if (PlannedStep(next) &&
+      space_search_->ReachableArea(*free_cells_, next, needed) >= needed) {
+    return;
+  }
+
+  static constexpr Direction kDirections[] = {Direction::kUp, Direction::kDown,
+                                              Direction::kLeft, Direction::kRight};
+  static constexpr int kOffsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  SDL_Point current_pos = head;
+  SDL_Point best{};
+  int best_area = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (size > 1 && kDirections[i] == Opposite(direction)) continue;
+    SDL_Point cell{(current_pos.x + kOffsets[i][0] + grid_width) % grid_width,
+                   (current_pos.y + kOffsets[i][1] + grid_height) % grid_height};
+    int area = space_search_->ReachableArea(*free_cells_, cell, needed);
+    if (area > best_area) {
+      best_area = area;
+      best = cell;
+    }
+  }
+  if (best_area > 0) {
+    current_path_.assign({current_pos, best});
+    path_index_ = 0;
+  }
+}
+
+// The cell FollowPath is about to steer into, if any.
+bool AISnake::PlannedStep(SDL_Point& next) const {
+  SDL_Point current_pos = head;
+  std::size_t index = path_index_;
+  if (index < current_path_.size() && current_path_[index].x == current_pos.x &&
+      current_path_[index].y == current_pos.y) {
+    index++;
+  }
+  if (index >= current_path_.size()) {
+    return false;
+  }
+  next = current_path_[index];
+  return true;
 }
 
 SnakeBase::Direction AISnake::GetDirectionToPoint(const SDL_Point& point) const {
-  int dx = point.x - static_cast<int>(head_x);
-  int dy = point.y - static_cast<int>(head_y);
+  int dx = point.x - head.x;
+  int dy = point.y - head.y;
   
   if (dx > grid_width / 2) dx -= grid_width;
   if (dx < -grid_width / 2) dx += grid_width;
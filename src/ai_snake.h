@@ -2,32 +2,92 @@
 #define AI_SNAKE_H
 
 #include "snake_base.h"
-#include "astar_pathfinder.h"
+#include "pathfinder.h"
+#include "dstar_lite.h"
+#include "distance_field.h"
+#include "bit_grid.h"
+#include "mcts_planner.h"
 #include <memory>
 #include <vector>
 #include <random>
 
+// How the AI finds its way to the food. kAStar searches from scratch every
+// few moves; kIncremental keeps a D* Lite search alive for the current food
+// and repairs it as the snakes move, so it can replan on every step.
+// kDistanceField steps down a DistanceField shared by every AI snake. kMcts
+// searches ahead with an MctsPlanner each time the head enters a cell.
+enum class AIPlanner { kAStar, kIncremental, kDistanceField, kMcts };
+
 class AISnake : public SnakeBase {
  public:
   AISnake(int grid_width, int grid_height);
+  AISnake(int grid_width, int grid_height, std::uint32_t seed);
+  AISnake(int grid_width, int grid_height, std::uint32_t seed, int spawn_x, int spawn_y);
   
   void Update() override;
   void SetTarget(const SDL_Point& target);
-  void SetObstacles(const std::vector<const SnakeBase*>& obstacles);
+  // Cells occupied by any snake, owned by the Game and indexed by
+  // y * grid_width + x. Must outlive the snake.
+  void SetBoard(const std::vector<std::uint8_t>* blocked) { board_ = blocked; }
+  void SetPlanner(AIPlanner planner);
+  // Search engine behind kAStar's periodic replans (A* by default).
+  void SetPathfinder(PathfinderEngine engine);
+  // Field to follow when the planner is kDistanceField. Not owned; it must
+  // outlive the snake.
+  void SetDistanceField(const DistanceField* field) { distance_field_ = field; }
+  // Search to consult when the planner is kMcts, and the snake to plan
+  // against. The snake then moves every tick and never blunders on purpose;
+  // its strength is the planner's budget. Neither is owned.
+  void SetMctsPlanner(MctsPlanner* planner, const SnakeBase* opponent) {
+    mcts_ = planner;
+    opponent_ = opponent;
+  }
+  // When set, a planned step into a pocket too small for the snake's body is
+  // swapped for the neighbour with the most room. Neither is owned.
+  void SetSpaceCheck(const BitGrid* free_cells, BitBoardSearch* search) {
+    free_cells_ = free_cells;
+    space_search_ = search;
+  }
+  // Tells the incremental planner that a board cell became blocked or free.
+  void OnCellChanged(int x, int y, bool blocked);
+
+  // With external planning the snake never runs A* itself: it raises a
+  // replan request instead and follows whatever path is handed to AdoptPath.
+  void SetExternalPlanning(bool external) { external_planning_ = external; }
+  bool TakeReplanRequest();
+  // Installs a path computed elsewhere, possibly against a slightly older
+  // board. It is picked up from the snake's current cell; if the snake has
+  // already left the path, it is dropped and a new one requested.
+  void AdoptPath(const std::vector<SDL_Point>& path);
   
  private:
-  std::unique_ptr<AStarPathfinder> pathfinder_;
+  std::unique_ptr<Pathfinder> pathfinder_;
+  std::unique_ptr<DStarLite> incremental_;
+  const DistanceField* distance_field_{nullptr};
+  MctsPlanner* mcts_{nullptr};
+  const SnakeBase* opponent_{nullptr};
+  // Cell the last MCTS decision was made in.
+  SDL_Point decided_cell_{-1, -1};
+  const BitGrid* free_cells_{nullptr};
+  BitBoardSearch* space_search_{nullptr};
   std::vector<SDL_Point> current_path_;
   SDL_Point target_;
-  std::vector<const SnakeBase*> obstacles_;
+  const std::vector<std::uint8_t>* board_{nullptr};
   int path_index_;
   int update_counter_;
   int movement_delay_counter_;
+  bool external_planning_{false};
+  bool replan_requested_{false};
   mutable std::mt19937 rng_;
   mutable std::uniform_int_distribution<int> fairness_dist_;
   
   void UpdatePath();
+  void UpdateIncrementalPath();
+  void UpdateFieldPath();
+  void UpdateMcts(SDL_Point prev_cell);
   void FollowPath();
+  void AvoidTraps();
+  bool PlannedStep(SDL_Point& next) const;
   Direction GetDirectionToPoint(const SDL_Point& point) const;
   bool ShouldRecalculatePath() const;
   bool ShouldMoveThisFrame() const;
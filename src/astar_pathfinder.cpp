@@ -1,104 +1,145 @@
 #include "astar_pathfinder.h"
 #include <cmath>
 #include <algorithm>
+#include "grid.h"
 
 AStarPathfinder::AStarPathfinder(int grid_width, int grid_height)
-    : grid_width_(grid_width), grid_height_(grid_height) {}
+    : grid_width_(grid_width),
+      grid_height_(grid_height),
+      cells_(static_cast<std::size_t>(grid_width) * grid_height) {
+  open_heap_.reserve(cells_.size());
+}
 
-std::vector<SDL_Point> AStarPathfinder::FindPath(const SDL_Point& start, 
-                                                 const SDL_Point& goal, 
+std::vector<SDL_Point> AStarPathfinder::FindPath(const SDL_Point& start,
+                                                 const SDL_Point& goal,
                                                  const std::vector<const SnakeBase*>& obstacles) {
-  std::priority_queue<Node> open_set;
-  std::unordered_set<std::pair<int, int>, NodeHash> closed_set;
-  std::unordered_set<std::pair<int, int>, NodeHash> open_set_coords;
-  
-  auto start_node = std::make_shared<Node>(start.x, start.y, 0, 
-                                           CalculateHeuristic(start.x, start.y, goal.x, goal.y));
-  open_set.push(*start_node);
-  open_set_coords.insert({start.x, start.y});
-  
-  while (!open_set.empty()) {
-    Node current = open_set.top();
-    open_set.pop();
-    
-    auto current_coords = std::make_pair(current.x, current.y);
-    open_set_coords.erase(current_coords);
-    closed_set.insert(current_coords);
-    
-    if (current.x == goal.x && current.y == goal.y) {
-      return ReconstructPath(std::make_shared<Node>(current));
+  std::vector<SDL_Point> path;
+  FindPath(start, goal, obstacles, path);
+  return path;
+}
+
+bool AStarPathfinder::FindPath(const SDL_Point& start, const SDL_Point& goal,
+                               const std::vector<const SnakeBase*>& obstacles,
+                               std::vector<SDL_Point>& path) {
+  return DispatchGrid(grid_width_, grid_height_, [&](const auto& grid) {
+    return Search(
+        grid, start, goal,
+        [&](int cell) { return !IsValidPosition(grid.X(cell), grid.Y(cell), obstacles); }, path);
+  });
+}
+
+bool AStarPathfinder::FindPath(const SDL_Point& start, const SDL_Point& goal,
+                               const std::vector<std::uint8_t>& blocked,
+                               std::vector<SDL_Point>& path) {
+  return DispatchGrid(grid_width_, grid_height_, [&](const auto& grid) {
+    return Search(grid, start, goal, [&](int cell) { return blocked[cell] != 0; }, path);
+  });
+}
+
+template <typename GridT, typename IsBlocked>
+bool AStarPathfinder::Search(const GridT& grid, const SDL_Point& start, const SDL_Point& goal,
+                             IsBlocked is_blocked, std::vector<SDL_Point>& path) {
+  path.clear();
+  BeginSearch();
+
+  int start_cell = grid.Index(start.x, start.y);
+  int goal_cell = grid.Index(goal.x, goal.y);
+
+  CellRecord& start_record = cells_[start_cell];
+  start_record.g_cost = 0;
+  start_record.parent = -1;
+  start_record.generation = generation_;
+  start_record.closed = false;
+  open_heap_.push_back({grid.Distance(start_cell, goal_cell), 0, start_cell});
+
+  while (!open_heap_.empty()) {
+    std::pop_heap(open_heap_.begin(), open_heap_.end(), HeapOrder);
+    OpenEntry current = open_heap_.back();
+    open_heap_.pop_back();
+
+    CellRecord& current_record = cells_[current.cell];
+    // Stale heap entry: the cell was already expanded, or reached later via
+    // a cheaper route that pushed a fresh entry.
+    if (current_record.closed || current.g_cost != current_record.g_cost) {
+      continue;
     }
-    
-    for (const auto& neighbor_coords : GetNeighbors(current.x, current.y)) {
-      int nx = neighbor_coords.first;
-      int ny = neighbor_coords.second;
-      
-      if (closed_set.find({nx, ny}) != closed_set.end()) {
-        continue;
-      }
-      
-      if (!IsValidPosition(nx, ny, obstacles)) {
-        continue;
-      }
-      
-      float tentative_g = current.g_cost + 1.0f;
-      float h_cost = CalculateHeuristic(nx, ny, goal.x, goal.y);
-      
-      if (open_set_coords.find({nx, ny}) == open_set_coords.end()) {
-        auto neighbor = std::make_shared<Node>(nx, ny, tentative_g, h_cost, 
-                                               std::make_shared<Node>(current));
-        open_set.push(*neighbor);
-        open_set_coords.insert({nx, ny});
+    current_record.closed = true;
+    expanded_++;
+
+    if (current.cell == goal_cell) {
+      ReconstructPath(goal_cell, path);
+      return true;
+    }
+
+    // Up, down, left, right: the order the searches have always used, so
+    // ties between equal paths break the same way on every grid type.
+    for (int direction = 0; direction < 4; ++direction) {
+      int neighbor_cell = grid.Neighbour(current.cell, direction);
+      CellRecord& record = cells_[neighbor_cell];
+
+      int tentative_g = current.g_cost + 1;
+      if (record.generation == generation_) {
+        if (record.closed || tentative_g >= record.g_cost) {
+          continue;
+        }
+      } else {
+        if (is_blocked(neighbor_cell)) {
+          // Remember the blocked cell as closed so it is only tested once.
+          record.generation = generation_;
+          record.closed = true;
+          continue;
+        }
+        record.generation = generation_;
+        record.closed = false;
       }
+
+      record.g_cost = tentative_g;
+      record.parent = current.cell;
+      open_heap_.push_back({tentative_g + grid.Distance(neighbor_cell, goal_cell), tentative_g,
+                            neighbor_cell});
+      std::push_heap(open_heap_.begin(), open_heap_.end(), HeapOrder);
     }
   }
-  
-  return std::vector<SDL_Point>();
+
+  return false;
 }
 
-float AStarPathfinder::CalculateHeuristic(int x1, int y1, int x2, int y2) const {
-  return std::abs(x1 - x2) + std::abs(y1 - y2);
+void AStarPathfinder::BeginSearch() {
+  open_heap_.clear();
+  expanded_ = 0;
+  if (++generation_ == 0) {
+    // Generation counter wrapped: old stamps could alias the new one.
+    for (auto& record : cells_) {
+      record.generation = 0;
+    }
+    generation_ = 1;
+  }
+}
+
+// Min-heap on f_cost; among equal f prefer the deeper node so the search
+// heads toward the goal instead of fanning out.
+bool AStarPathfinder::HeapOrder(const OpenEntry& a, const OpenEntry& b) {
+  if (a.f_cost != b.f_cost) return a.f_cost > b.f_cost;
+  return a.g_cost < b.g_cost;
 }
 
 bool AStarPathfinder::IsValidPosition(int x, int y, const std::vector<const SnakeBase*>& obstacles) const {
   if (x < 0 || x >= grid_width_ || y < 0 || y >= grid_height_) {
     return false;
   }
-  
+
   for (const auto* snake : obstacles) {
     if (snake && snake->SnakeCell(x, y)) {
       return false;
     }
   }
-  
+
   return true;
 }
 
-std::vector<SDL_Point> AStarPathfinder::ReconstructPath(std::shared_ptr<Node> goal_node) const {
-  std::vector<SDL_Point> path;
-  std::shared_ptr<Node> current = goal_node;
-  
-  while (current != nullptr) {
-    path.push_back({current->x, current->y});
-    current = current->parent;
+void AStarPathfinder::ReconstructPath(int goal_cell, std::vector<SDL_Point>& path) const {
+  for (int cell = goal_cell; cell != -1; cell = cells_[cell].parent) {
+    path.push_back({cell % grid_width_, cell / grid_width_});
   }
-  
   std::reverse(path.begin(), path.end());
-  return path;
 }
-
-std::vector<std::pair<int, int>> AStarPathfinder::GetNeighbors(int x, int y) const {
-  std::vector<std::pair<int, int>> neighbors;
-  
-  const std::vector<std::pair<int, int>> directions = {
-    {0, -1}, {0, 1}, {-1, 0}, {1, 0}
-  };
-  
-  for (const auto& dir : directions) {
-    int nx = (x + dir.first + grid_width_) % grid_width_;
-    int ny = (y + dir.second + grid_height_) % grid_height_;
-    neighbors.push_back({nx, ny});
-  }
-  
-  return neighbors;
-}
\ No newline at end of file
@@ -1,49 +1,66 @@
 #ifndef ASTAR_PATHFINDER_H
 #define ASTAR_PATHFINDER_H
 
+#include <cstdint>
 #include <vector>
-#include <queue>
-#include <unordered_set>
-#include <memory>
-#include "SDL.h"
+#include "sdl_types.h"
+#include "pathfinder.h"
 #include "snake_base.h"
 
-struct Node {
-  int x, y;
-  float g_cost;
-  float h_cost;
-  float f_cost;
-  std::shared_ptr<Node> parent;
-  
-  Node(int x, int y, float g = 0, float h = 0, std::shared_ptr<Node> parent = nullptr)
-      : x(x), y(y), g_cost(g), h_cost(h), f_cost(g + h), parent(parent) {}
-      
-  bool operator<(const Node& other) const {
-    return f_cost > other.f_cost;
-  }
-};
-
-struct NodeHash {
-  std::size_t operator()(const std::pair<int, int>& p) const {
-    return std::hash<int>()(p.first) ^ (std::hash<int>()(p.second) << 1);
-  }
-};
-
-class AStarPathfinder {
+// A* with a Manhattan distance heuristic measured the short way around the
+// wrap-around board, so it never overestimates and paths are shortest.
+class AStarPathfinder : public Pathfinder {
  public:
   AStarPathfinder(int grid_width, int grid_height);
-  
-  std::vector<SDL_Point> FindPath(const SDL_Point& start, const SDL_Point& goal, 
+
+  std::vector<SDL_Point> FindPath(const SDL_Point& start, const SDL_Point& goal,
                                   const std::vector<const SnakeBase*>& obstacles);
-  
+
+  // Same search, but writes into |path| so its storage is reused between
+  // calls. Returns false (and leaves |path| empty) if the goal is unreachable.
+  bool FindPath(const SDL_Point& start, const SDL_Point& goal,
+                const std::vector<const SnakeBase*>& obstacles,
+                std::vector<SDL_Point>& path);
+
+  // Same search against a flat grid of blocked cells (non-zero = blocked),
+  // indexed by y * grid_width + x. Used on board snapshots, where no live
+  // snake objects are available.
+  bool FindPath(const SDL_Point& start, const SDL_Point& goal,
+                const std::vector<std::uint8_t>& blocked,
+                std::vector<SDL_Point>& path) override;
+
  private:
+  // Search record for one grid cell, indexed by y * grid_width_ + x. A record
+  // only holds valid data when its generation matches the current search, so
+  // the arena never has to be cleared between calls.
+  struct CellRecord {
+    int g_cost{0};
+    int parent{-1};
+    unsigned int generation{0};
+    bool closed{false};
+  };
+
+  struct OpenEntry {
+    int f_cost;
+    int g_cost;
+    int cell;
+  };
+
   int grid_width_;
   int grid_height_;
-  
-  float CalculateHeuristic(int x1, int y1, int x2, int y2) const;
+  std::vector<CellRecord> cells_;
+  std::vector<OpenEntry> open_heap_;
+  unsigned int generation_{0};
+
+  // Shared A* core over the board's Grid type (see grid.h);
+  // |is_blocked(cell)| answers the obstacle test.
+  template <typename GridT, typename IsBlocked>
+  bool Search(const GridT& grid, const SDL_Point& start, const SDL_Point& goal,
+              IsBlocked is_blocked, std::vector<SDL_Point>& path);
+  static bool HeapOrder(const OpenEntry& a, const OpenEntry& b);
+  void BeginSearch();
   bool IsValidPosition(int x, int y, const std::vector<const SnakeBase*>& obstacles) const;
-  std::vector<SDL_Point> ReconstructPath(std::shared_ptr<Node> goal_node) const;
-  std::vector<std::pair<int, int>> GetNeighbors(int x, int y) const;
+  void ReconstructPath(int goal_cell, std::vector<SDL_Point>& path) const;
 };
 
-#endif
\ No newline at end of file
+#endif
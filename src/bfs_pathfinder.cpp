@@ -0,0 +1,66 @@
+#include "bfs_pathfinder.h"
+#include <algorithm>
+#include "grid.h"
+
+BfsPathfinder::BfsPathfinder(int grid_width, int grid_height)
+    : grid_width_(grid_width),
+      grid_height_(grid_height),
+      parent_(static_cast<std::size_t>(grid_width) * grid_height),
+      visited_(parent_.size(), 0) {
+  queue_.reserve(parent_.size());
+}
+
+bool BfsPathfinder::FindPath(const SDL_Point& start, const SDL_Point& goal,
+                             const std::vector<std::uint8_t>& blocked,
+                             std::vector<SDL_Point>& path) {
+  path.clear();
+  expanded_ = 0;
+  if (++generation_ == 0) {
+    std::fill(visited_.begin(), visited_.end(), 0);
+    generation_ = 1;
+  }
+
+  int start_cell = start.y * grid_width_ + start.x;
+  int goal_cell = goal.y * grid_width_ + goal.x;
+  bool found = DispatchGrid(grid_width_, grid_height_, [&](const auto& grid) {
+    return Search(grid, start_cell, goal_cell, blocked);
+  });
+  if (!found) {
+    return false;
+  }
+
+  for (int cell = goal_cell; cell != -1; cell = parent_[cell]) {
+    path.push_back({cell % grid_width_, cell / grid_width_});
+  }
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+template <typename GridT>
+bool BfsPathfinder::Search(const GridT& grid, int start_cell, int goal_cell,
+                           const std::vector<std::uint8_t>& blocked) {
+  queue_.clear();
+  queue_.push_back(start_cell);
+  visited_[start_cell] = generation_;
+  parent_[start_cell] = -1;
+
+  // queue_ never holds a cell twice, so it doubles as the visit order and
+  // is walked with an index instead of popped.
+  bool found = start_cell == goal_cell;
+  for (std::size_t head = 0; head < queue_.size() && !found; ++head) {
+    int cell = queue_[head];
+    expanded_++;
+    for (int direction = 0; direction < 4; ++direction) {
+      int next = grid.Neighbour(cell, direction);
+      if (visited_[next] == generation_ || blocked[next]) continue;
+      visited_[next] = generation_;
+      parent_[next] = cell;
+      if (next == goal_cell) {
+        found = true;
+        break;
+      }
+      queue_.push_back(next);
+    }
+  }
+  return found;
+}
@@ -0,0 +1,35 @@
+#ifndef BFS_PATHFINDER_H
+#define BFS_PATHFINDER_H
+
+#include <cstdint>
+#include <vector>
+#include "pathfinder.h"
+
+// Breadth-first search from the start. Every step costs the same, so the
+// first time the goal is reached is along a shortest path; there is no heap
+// and no heuristic, which on small boards beats A*'s smaller frontier.
+class BfsPathfinder : public Pathfinder {
+ public:
+  BfsPathfinder(int grid_width, int grid_height);
+
+  bool FindPath(const SDL_Point& start, const SDL_Point& goal,
+                const std::vector<std::uint8_t>& blocked,
+                std::vector<SDL_Point>& path) override;
+
+ private:
+  int grid_width_;
+  int grid_height_;
+  // Predecessor of each reached cell, valid where visited_ holds the
+  // current generation.
+  std::vector<int> parent_;
+  std::vector<unsigned int> visited_;
+  std::vector<int> queue_;
+  unsigned int generation_{0};
+
+  // Fills parent_ until the goal is reached; see grid.h for GridT.
+  template <typename GridT>
+  bool Search(const GridT& grid, int start_cell, int goal_cell,
+              const std::vector<std::uint8_t>& blocked);
+};
+
+#endif
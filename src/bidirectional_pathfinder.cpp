@@ -0,0 +1,101 @@
+#include "bidirectional_pathfinder.h"
+#include <algorithm>
+#include <limits>
+#include "grid.h"
+
+BidirectionalPathfinder::BidirectionalPathfinder(int grid_width, int grid_height)
+    : grid_width_(grid_width), grid_height_(grid_height) {
+  std::size_t cells = static_cast<std::size_t>(grid_width) * grid_height;
+  for (int side : {kForward, kBackward}) {
+    cells_[side].resize(cells);
+    frontier_[side].reserve(cells);
+  }
+  next_.reserve(cells);
+}
+
+bool BidirectionalPathfinder::FindPath(const SDL_Point& start, const SDL_Point& goal,
+                                       const std::vector<std::uint8_t>& blocked,
+                                       std::vector<SDL_Point>& path) {
+  path.clear();
+  expanded_ = 0;
+  if (++generation_ == 0) {
+    for (auto& side : cells_) {
+      for (auto& record : side) record.generation = 0;
+    }
+    generation_ = 1;
+  }
+
+  int start_cell = start.y * grid_width_ + start.x;
+  int goal_cell = goal.y * grid_width_ + goal.x;
+  if (start_cell == goal_cell) {
+    path.push_back(start);
+    return true;
+  }
+  for (int side : {kForward, kBackward}) {
+    int cell = side == kForward ? start_cell : goal_cell;
+    cells_[side][cell] = CellRecord{-1, 0, generation_};
+    frontier_[side].assign(1, cell);
+  }
+
+  int meet_forward = -1;
+  int meet_backward = -1;
+  bool met = DispatchGrid(grid_width_, grid_height_, [&](const auto& grid) {
+    return Search(grid, blocked, meet_forward, meet_backward);
+  });
+  if (!met) {
+    return false;
+  }
+  ReconstructPath(meet_forward, meet_backward, path);
+  return true;
+}
+
+template <typename GridT>
+bool BidirectionalPathfinder::Search(const GridT& grid, const std::vector<std::uint8_t>& blocked,
+                                     int& meet_forward, int& meet_backward) {
+  // A layer that finds a meeting cell is still finished, since a later cell
+  // of the same layer may meet the other side at a smaller depth.
+  int best = std::numeric_limits<int>::max();
+  while (!frontier_[kForward].empty() && !frontier_[kBackward].empty()) {
+    int side = frontier_[kForward].size() <= frontier_[kBackward].size() ? kForward : kBackward;
+    int other = 1 - side;
+    next_.clear();
+    for (int cell : frontier_[side]) {
+      expanded_++;
+      int depth = cells_[side][cell].depth + 1;
+      for (int direction = 0; direction < 4; ++direction) {
+        int next = grid.Neighbour(cell, direction);
+        // Checked before |blocked|: the start is usually a snake's head.
+        if (Reached(other, next)) {
+          int length = depth + cells_[other][next].depth;
+          if (length < best) {
+            best = length;
+            meet_forward = side == kForward ? cell : next;
+            meet_backward = side == kForward ? next : cell;
+          }
+          continue;
+        }
+        if (Reached(side, next) || blocked[next]) continue;
+        cells_[side][next] = CellRecord{cell, depth, generation_};
+        next_.push_back(next);
+      }
+    }
+    if (meet_forward != -1) {
+      return true;
+    }
+    frontier_[side].swap(next_);
+  }
+  return false;
+}
+
+// Start to |forward_cell| along the forward parents, then |backward_cell|
+// to the goal along the backward ones.
+void BidirectionalPathfinder::ReconstructPath(int forward_cell, int backward_cell,
+                                              std::vector<SDL_Point>& path) const {
+  for (int cell = forward_cell; cell != -1; cell = cells_[kForward][cell].parent) {
+    path.push_back({cell % grid_width_, cell / grid_width_});
+  }
+  std::reverse(path.begin(), path.end());
+  for (int cell = backward_cell; cell != -1; cell = cells_[kBackward][cell].parent) {
+    path.push_back({cell % grid_width_, cell / grid_width_});
+  }
+}
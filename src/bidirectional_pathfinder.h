@@ -0,0 +1,48 @@
+#ifndef BIDIRECTIONAL_PATHFINDER_H
+#define BIDIRECTIONAL_PATHFINDER_H
+
+#include <cstdint>
+#include <vector>
+#include "pathfinder.h"
+
+// Breadth-first search grown from the start and the goal at once, a whole
+// layer at a time from whichever frontier is smaller. The two searches meet
+// around the middle, so each covers roughly a radius of half the distance
+// instead of the full one.
+class BidirectionalPathfinder : public Pathfinder {
+ public:
+  BidirectionalPathfinder(int grid_width, int grid_height);
+
+  bool FindPath(const SDL_Point& start, const SDL_Point& goal,
+                const std::vector<std::uint8_t>& blocked,
+                std::vector<SDL_Point>& path) override;
+
+ private:
+  static constexpr int kForward = 0;
+  static constexpr int kBackward = 1;
+
+  // Per-side search state for one cell, valid where generation matches the
+  // current search.
+  struct CellRecord {
+    int parent{-1};
+    int depth{0};
+    unsigned int generation{0};
+  };
+
+  int grid_width_;
+  int grid_height_;
+  std::vector<CellRecord> cells_[2];
+  std::vector<int> frontier_[2];
+  std::vector<int> next_;
+  unsigned int generation_{0};
+
+  bool Reached(int side, int cell) const { return cells_[side][cell].generation == generation_; }
+  // Grows the two searches until they meet; see grid.h for GridT. Returns
+  // the meeting cells, or false if either side runs out of cells.
+  template <typename GridT>
+  bool Search(const GridT& grid, const std::vector<std::uint8_t>& blocked, int& meet_forward,
+              int& meet_backward);
+  void ReconstructPath(int forward_cell, int backward_cell, std::vector<SDL_Point>& path) const;
+};
+
+#endif
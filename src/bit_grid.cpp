@@ -0,0 +1,345 @@
+#include "bit_grid.h"
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SNAKE_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+int PopCount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  int count = 0;
+  for (; word; word &= word - 1) count++;
+  return count;
+#endif
+}
+
+// One row of a BFS layer. Every pointer is a BitGrid row, so index -1 and
+// |words| are readable guard words.
+struct RowStep {
+  const std::uint64_t* above;
+  const std::uint64_t* cur;
+  const std::uint64_t* below;
+  const std::uint64_t* free;
+  std::uint64_t* visited;
+  std::uint64_t* out;
+  int words;
+  int width;
+};
+
+// Adds the two cells that wrap around the row ends, which the word shifts
+// cannot see.
+std::size_t WrapRowEnds(const RowStep& row) {
+  int last = (row.width - 1) >> 6;
+  std::uint64_t last_bit = std::uint64_t{1} << ((row.width - 1) & 63);
+  std::uint64_t from_right = (row.cur[last] & last_bit) ? 1 : 0;
+  std::uint64_t from_left = (row.cur[0] & 1) ? last_bit : 0;
+
+  std::uint64_t add = from_right & row.free[0] & ~row.visited[0];
+  row.out[0] |= add;
+  row.visited[0] |= add;
+  std::size_t count = PopCount(add);
+
+  add = from_left & row.free[last] & ~row.visited[last];
+  row.out[last] |= add;
+  row.visited[last] |= add;
+  return count + PopCount(add);
+}
+
+std::size_t StepRowScalar(const RowStep& row, int begin) {
+  std::size_t count = 0;
+  for (int i = begin; i < row.words; ++i) {
+    std::uint64_t cur = row.cur[i];
+    std::uint64_t left = (cur << 1) | (row.cur[i - 1] >> 63);
+    std::uint64_t right = (cur >> 1) | (row.cur[i + 1] << 63);
+    std::uint64_t reached = cur | left | right | row.above[i] | row.below[i];
+    std::uint64_t next = reached & row.free[i] & ~row.visited[i];
+    row.out[i] = next;
+    row.visited[i] |= next;
+    count += PopCount(next);
+  }
+  return count;
+}
+
+#ifdef SNAKE_HAVE_AVX2_KERNEL
+__attribute__((target("avx2,popcnt")))
+std::size_t StepRowAvx2(const RowStep& row) {
+  std::size_t count = 0;
+  int i = 0;
+  for (; i + 4 <= row.words; i += 4) {
+    __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.cur + i));
+    __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.cur + i - 1));
+    __m256i succ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.cur + i + 1));
+    __m256i left = _mm256_or_si256(_mm256_slli_epi64(cur, 1), _mm256_srli_epi64(prev, 63));
+    __m256i right = _mm256_or_si256(_mm256_srli_epi64(cur, 1), _mm256_slli_epi64(succ, 63));
+    __m256i vertical = _mm256_or_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.above + i)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.below + i)));
+    __m256i reached = _mm256_or_si256(_mm256_or_si256(cur, vertical), _mm256_or_si256(left, right));
+    __m256i visited = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.visited + i));
+    __m256i free = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.free + i));
+    __m256i next = _mm256_andnot_si256(visited, _mm256_and_si256(reached, free));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(row.out + i), next);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(row.visited + i), _mm256_or_si256(visited, next));
+    if (!_mm256_testz_si256(next, next)) {
+      count += _mm_popcnt_u64(_mm256_extract_epi64(next, 0)) +
+               _mm_popcnt_u64(_mm256_extract_epi64(next, 1)) +
+               _mm_popcnt_u64(_mm256_extract_epi64(next, 2)) +
+               _mm_popcnt_u64(_mm256_extract_epi64(next, 3));
+    }
+  }
+  return count + StepRowScalar(row, i);
+}
+#endif
+
+std::size_t StepRow(const RowStep& row, bool simd) {
+  std::size_t count;
+#ifdef SNAKE_HAVE_AVX2_KERNEL
+  count = simd ? StepRowAvx2(row) : StepRowScalar(row, 0);
+#else
+  (void)simd;
+  count = StepRowScalar(row, 0);
+#endif
+  return count + WrapRowEnds(row);
+}
+
+// Kogge-Stone occluded fills: extend every run of |gen| through the set
+// bits of |pro| toward higher (FillUp) or lower (FillDown) bit positions.
+std::uint64_t FillUp(std::uint64_t gen, std::uint64_t pro) {
+  gen |= pro & (gen << 1);
+  pro &= pro << 1;
+  gen |= pro & (gen << 2);
+  pro &= pro << 2;
+  gen |= pro & (gen << 4);
+  pro &= pro << 4;
+  gen |= pro & (gen << 8);
+  pro &= pro << 8;
+  gen |= pro & (gen << 16);
+  pro &= pro << 16;
+  return gen | (pro & (gen << 32));
+}
+
+std::uint64_t FillDown(std::uint64_t gen, std::uint64_t pro) {
+  gen |= pro & (gen >> 1);
+  pro &= pro >> 1;
+  gen |= pro & (gen >> 2);
+  pro &= pro >> 2;
+  gen |= pro & (gen >> 4);
+  pro &= pro >> 4;
+  gen |= pro & (gen >> 8);
+  pro &= pro >> 8;
+  gen |= pro & (gen >> 16);
+  pro &= pro >> 16;
+  return gen | (pro & (gen >> 32));
+}
+
+// Fills |row| along every run of free cells it touches, wrapping around the
+// row ends.
+void FillRow(std::uint64_t* row, const std::uint64_t* free, int words, int width) {
+  int last = (width - 1) >> 6;
+  std::uint64_t last_bit = std::uint64_t{1} << ((width - 1) & 63);
+  while (true) {
+    std::uint64_t carry = 0;
+    for (int i = 0; i < words; ++i) {
+      row[i] = FillUp(row[i] | (carry & free[i]), free[i]);
+      carry = row[i] >> 63;
+    }
+    carry = 0;
+    for (int i = words - 1; i >= 0; --i) {
+      row[i] = FillDown(row[i] | ((carry << 63) & free[i]), free[i]);
+      carry = row[i] & 1;
+    }
+
+    bool wrap_left = (row[last] & last_bit) && (free[0] & 1) && !(row[0] & 1);
+    bool wrap_right = (row[0] & 1) && (free[last] & last_bit) && !(row[last] & last_bit);
+    if (!wrap_left && !wrap_right) return;
+    if (wrap_left) row[0] |= 1;
+    if (wrap_right) row[last] |= last_bit;
+  }
+}
+
+}  // namespace
+
+BitGrid::BitGrid(int grid_width, int grid_height)
+    : width_(grid_width),
+      height_(grid_height),
+      words_per_row_((grid_width + 63) / 64),
+      stride_(words_per_row_ + 2),
+      last_word_mask_((grid_width & 63) ? (std::uint64_t{1} << (grid_width & 63)) - 1
+                                        : ~std::uint64_t{0}),
+      words_(static_cast<std::size_t>(stride_) * grid_height, 0) {}
+
+void BitGrid::Clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+void BitGrid::Fill() {
+  for (int y = 0; y < height_; ++y) {
+    std::uint64_t* row = Row(y);
+    std::fill(row, row + words_per_row_, ~std::uint64_t{0});
+    row[words_per_row_ - 1] = last_word_mask_;
+  }
+}
+
+void BitGrid::ClearRow(int y) {
+  std::uint64_t* row = Row(y);
+  std::fill(row, row + words_per_row_, 0);
+}
+
+std::size_t BitGrid::Count() const {
+  std::size_t count = 0;
+  for (std::uint64_t word : words_) count += PopCount(word);
+  return count;
+}
+
+BitBoardSearch::BitBoardSearch(int grid_width, int grid_height)
+    : visited_(grid_width, grid_height),
+      frontier_(grid_width, grid_height),
+      next_(grid_width, grid_height),
+      active_(grid_height, 0),
+      next_active_(grid_height, 0),
+      touched_(grid_height, 0),
+      simd_(CpuHasAvx2()) {}
+
+bool BitBoardSearch::CpuHasAvx2() {
+#ifdef SNAKE_HAVE_AVX2_KERNEL
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#else
+  return false;
+#endif
+}
+
+int BitBoardSearch::ReachableArea(const BitGrid& free, const SDL_Point& start, int limit) {
+  if (!free.Test(start.x, start.y)) {
+    return 0;
+  }
+  Begin(start);
+  std::size_t area = 1;
+  while (area < static_cast<std::size_t>(limit)) {
+    std::size_t added = Step(free);
+    if (added == 0) break;
+    area += added;
+  }
+  return static_cast<int>(std::min<std::size_t>(area, limit));
+}
+
+std::size_t BitBoardSearch::FloodFill(const BitGrid& free, const SDL_Point& start) {
+  Begin(start);
+  if (!free.Test(start.x, start.y)) {
+    visited_.Reset(start.x, start.y);
+    return 0;
+  }
+
+  int height = visited_.Height();
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int y = 0; y < height; ++y) {
+      changed |= SweepRow(y, (y + height - 1) % height, free);
+    }
+    for (int y = height - 1; y >= 0; --y) {
+      changed |= SweepRow(y, (y + 1) % height, free);
+    }
+  }
+
+  std::size_t count = 0;
+  for (int y = 0; y < height; ++y) {
+    if (!touched_[y]) continue;
+    const std::uint64_t* row = visited_.Row(y);
+    for (int i = 0; i < visited_.WordsPerRow(); ++i) count += PopCount(row[i]);
+  }
+  return count;
+}
+
+// Pulls reached cells from row |from| into row |y| and fills them out along
+// the row. Returns true if row |y| gained cells, including the first fill of
+// the start row, which has no seeds but may still reach along it.
+bool BitBoardSearch::SweepRow(int y, int from, const BitGrid& free) {
+  if (!touched_[y] && !touched_[from]) {
+    return false;
+  }
+  std::uint64_t* row = visited_.Row(y);
+  const std::uint64_t* source = visited_.Row(from);
+  const std::uint64_t* open = free.Row(y);
+  int words = visited_.WordsPerRow();
+
+  bool first_fill = touched_[y] == 1;
+  bool seeded = false;
+  for (int i = 0; i < words; ++i) {
+    std::uint64_t add = source[i] & open[i] & ~row[i];
+    row[i] |= add;
+    seeded |= add != 0;
+  }
+  if (!seeded && !first_fill) {
+    return false;
+  }
+  FillRow(row, open, words, visited_.Width());
+  // 2 marks a row filled since it last gained cells, so it is only refilled
+  // when new seeds arrive.
+  touched_[y] = 2;
+  return seeded || first_fill;
+}
+
+int BitBoardSearch::Distance(const BitGrid& free, const SDL_Point& start, const SDL_Point& goal) {
+  if (start.x == goal.x && start.y == goal.y) {
+    return 0;
+  }
+  Begin(start);
+  for (int steps = 1;; ++steps) {
+    if (Step(free) == 0) {
+      return -1;
+    }
+    if (visited_.Test(goal.x, goal.y)) {
+      return steps;
+    }
+  }
+}
+
+// Resets only the rows the previous query touched.
+void BitBoardSearch::Begin(const SDL_Point& start) {
+  for (int y = 0; y < visited_.Height(); ++y) {
+    if (touched_[y]) {
+      visited_.ClearRow(y);
+      frontier_.ClearRow(y);
+      next_.ClearRow(y);
+      touched_[y] = 0;
+    }
+  }
+  std::fill(active_.begin(), active_.end(), 0);
+  std::fill(next_active_.begin(), next_active_.end(), 0);
+
+  visited_.Set(start.x, start.y);
+  frontier_.Set(start.x, start.y);
+  active_[start.y] = 1;
+  touched_[start.y] = 1;
+}
+
+// Advances the frontier by one BFS layer and returns how many cells it
+// reached. Rows more than one away from the old frontier cannot gain cells,
+// so they are skipped (and cleared if they still hold an older layer).
+std::size_t BitBoardSearch::Step(const BitGrid& free) {
+  int height = visited_.Height();
+  std::size_t total = 0;
+  for (int y = 0; y < height; ++y) {
+    int up = (y + height - 1) % height;
+    int down = (y + 1) % height;
+    if (!(active_[up] | active_[y] | active_[down])) {
+      if (next_active_[y]) {
+        next_.ClearRow(y);
+        next_active_[y] = 0;
+      }
+      continue;
+    }
+    RowStep row{frontier_.Row(up), frontier_.Row(y), frontier_.Row(down), free.Row(y),
+                visited_.Row(y), next_.Row(y), visited_.WordsPerRow(), visited_.Width()};
+    std::size_t added = StepRow(row, simd_);
+    next_active_[y] = added != 0;
+    touched_[y] |= added != 0;
+    total += added;
+  }
+  std::swap(frontier_, next_);
+  std::swap(active_, next_active_);
+  return total;
+}
@@ -0,0 +1,91 @@
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <cstdint>
+#include <vector>
+#include "sdl_types.h"
+
+// One bit per cell, packed 64 cells to a word along each row. Every row is
+// stored between two zero guard words, so kernels can read the word before
+// and after any word without bounds checks. Bits past grid_width in a row's
+// last word are always zero.
+class BitGrid {
+ public:
+  BitGrid(int grid_width, int grid_height);
+
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+  int WordsPerRow() const { return words_per_row_; }
+
+  std::uint64_t* Row(int y) { return &words_[static_cast<std::size_t>(y) * stride_ + 1]; }
+  const std::uint64_t* Row(int y) const {
+    return &words_[static_cast<std::size_t>(y) * stride_ + 1];
+  }
+
+  bool Test(int x, int y) const { return (Row(y)[x >> 6] >> (x & 63)) & 1; }
+  void Set(int x, int y) { Row(y)[x >> 6] |= std::uint64_t{1} << (x & 63); }
+  void Reset(int x, int y) { Row(y)[x >> 6] &= ~(std::uint64_t{1} << (x & 63)); }
+
+  // Clears every cell, or sets every cell of the grid (never the padding).
+  void Clear();
+  void Fill();
+  void ClearRow(int y);
+  std::size_t Count() const;
+  // Mask of the real cells in a row's last word.
+  std::uint64_t LastWordMask() const { return last_word_mask_; }
+
+ private:
+  int width_;
+  int height_;
+  int words_per_row_;
+  int stride_;
+  std::uint64_t last_word_mask_;
+  std::vector<std::uint64_t> words_;
+};
+
+// Breadth-first search over a BitGrid of free cells, one whole layer per
+// step: next = neighbours(frontier) & free & ~visited, on the wrap-around
+// 4-connected grid. Rows are processed 64 cells per word, four words at a
+// time with AVX2 when the CPU has it, and only rows next to the current
+// frontier are touched. The scratch grids are reused, so queries do not
+// allocate.
+class BitBoardSearch {
+ public:
+  BitBoardSearch(int grid_width, int grid_height);
+
+  // Free cells reachable from |start|, |start| included. Stops early once
+  // the count reaches |limit|, so "is there room for N cells" is cheap.
+  // Returns 0 if |start| itself is not free.
+  int ReachableArea(const BitGrid& free, const SDL_Point& start, int limit);
+  // Every free cell connected to |start|, left in Reached(); returns the
+  // count. Sweeps the board down and up, filling whole runs of each row with
+  // word-wide occluded fills, until nothing changes, so open boards settle
+  // in a few sweeps instead of one step per BFS layer.
+  std::size_t FloodFill(const BitGrid& free, const SDL_Point& start);
+  const BitGrid& Reached() const { return visited_; }
+  // Steps from |start| to |goal| through free cells, or -1 if the goal
+  // cannot be reached. |start| may itself be blocked, e.g. a snake's head.
+  int Distance(const BitGrid& free, const SDL_Point& start, const SDL_Point& goal);
+
+  // AVX2 is used when the CPU supports it; benchmarks can turn it off.
+  void SetSimd(bool enabled) { simd_ = enabled && CpuHasAvx2(); }
+  bool UsesSimd() const { return simd_; }
+  static bool CpuHasAvx2();
+
+ private:
+  BitGrid visited_;
+  BitGrid frontier_;
+  BitGrid next_;
+  // Rows of frontier_/next_ that hold any bits, and rows visited_ touched
+  // since the last query.
+  std::vector<std::uint8_t> active_;
+  std::vector<std::uint8_t> next_active_;
+  std::vector<std::uint8_t> touched_;
+  bool simd_;
+
+  void Begin(const SDL_Point& start);
+  bool SweepRow(int y, int from, const BitGrid& free);
+  std::size_t Step(const BitGrid& free);
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "board_view.h"
+#include <algorithm>
+#include <cmath>
+#include "game.h"
+
+BoardView::BoardView(std::size_t screen_width, std::size_t screen_height,
+                     std::size_t grid_width, std::size_t grid_height)
+    : screen_width_(static_cast<int>(screen_width)),
+      screen_height_(static_cast<int>(screen_height)),
+      grid_width_(static_cast<int>(grid_width)),
+      grid_height_(static_cast<int>(grid_height)) {
+  int fit = std::min(screen_width_ / grid_width_, screen_height_ / grid_height_);
+  cell_size_ = fit >= kMinFitCellSize ? std::min(fit, kMaxCellSize) : kDefaultCellSize;
+}
+
+void BoardView::ZoomIn() { cell_size_ = std::min(cell_size_ * 2, kMaxCellSize); }
+
+void BoardView::ZoomOut() { cell_size_ = std::max(cell_size_ / 2, 1); }
+
+// An axis that fits on screen is shown whole from cell 0; otherwise it is
+// centred on the player's head. Snake bodies come from the owner grid (heads
+// included), the food is drawn under them and dead heads on top.
+void BoardView::Update(PlayerSnake const &player_snake,
+                       std::vector<std::shared_ptr<AISnake>> const &ai_snakes,
+                       SDL_Point const &food, std::vector<std::uint16_t> const &owners,
+                       float alpha) {
+  columns_ = std::min(grid_width_, (screen_width_ + cell_size_ - 1) / cell_size_);
+  rows_ = std::min(grid_height_, (screen_height_ + cell_size_ - 1) / cell_size_);
+  SDL_Point head = player_snake.GetHeadCell();
+  origin_x_ = columns_ == grid_width_
+                  ? 0
+                  : ((head.x - columns_ / 2) % grid_width_ + grid_width_) % grid_width_;
+  origin_y_ = rows_ == grid_height_
+                  ? 0
+                  : ((head.y - rows_ / 2) % grid_height_ + grid_height_) % grid_height_;
+
+  colours_.resize(static_cast<std::size_t>(columns_) * rows_);
+  std::uint8_t *out = colours_.data();
+  for (int row = 0; row < rows_; ++row) {
+    int y = (origin_y_ + row) % grid_height_;
+    const std::uint16_t *cells = owners.data() + static_cast<std::size_t>(y) * grid_width_;
+    int x = origin_x_;
+    for (int column = 0; column < columns_; ++column) {
+      std::uint16_t owner = cells[x];
+      if (++x == grid_width_) x = 0;
+      *out++ = owner == 0 ? kBackground : owner == Game::kPlayerOwner ? kPlayer : kAI;
+    }
+  }
+
+  int cell = ViewCell(food.x, food.y);
+  if (cell >= 0 && colours_[cell] == kBackground) {
+    colours_[cell] = kFood;
+  }
+
+  auto paint_dead_head = [this](const SnakeBase &snake) {
+    if (snake.IsAlive()) return;
+    SDL_Point head = snake.GetHeadCell();
+    int cell = ViewCell(head.x, head.y);
+    if (cell >= 0) colours_[cell] = kDeadHead;
+  };
+  paint_dead_head(player_snake);
+  for (auto const &ai_snake : ai_snakes) {
+    paint_dead_head(*ai_snake);
+  }
+
+  heads_.clear();
+  AddHeadMarker(player_snake, kPlayer, alpha);
+  for (auto const &ai_snake : ai_snakes) {
+    AddHeadMarker(*ai_snake, kAI, alpha);
+  }
+}
+
+// The marker is the head cell moved by the head's progress toward the next
+// cell, interpolated from where it was at the start of the tick.
+void BoardView::AddHeadMarker(const SnakeBase &snake, Colour colour, float alpha) {
+  if (!snake.IsAlive()) return;
+
+  // Shortest way round the board from the previous head position.
+  auto interpolate = [alpha](float from, float to, int size) {
+    float delta = to - from;
+    if (delta > size / 2.0f) delta -= size;
+    if (delta < -size / 2.0f) delta += size;
+    return from + alpha * delta;
+  };
+  float x = interpolate(snake.GetPreviousHeadPositionX(), snake.GetHeadPositionX(), grid_width_);
+  float y = interpolate(snake.GetPreviousHeadPositionY(), snake.GetHeadPositionY(), grid_height_);
+
+  // Position relative to the view origin, wrapped into [0, grid size).
+  float column = std::fmod(x - origin_x_ + 2 * grid_width_, static_cast<float>(grid_width_));
+  float row = std::fmod(y - origin_y_ + 2 * grid_height_, static_cast<float>(grid_height_));
+  int left = static_cast<int>(std::lround(column * cell_size_));
+  int top = static_cast<int>(std::lround(row * cell_size_));
+  int right = std::min({left + cell_size_, columns_ * cell_size_, screen_width_});
+  int bottom = std::min({top + cell_size_, rows_ * cell_size_, screen_height_});
+  if (left < right && top < bottom) {
+    heads_.push_back({{left, top, right - left, bottom - top}, colour});
+  }
+}
+
+// Index of grid cell (x, y) in colours_, or -1 if the cell is off screen.
+int BoardView::ViewCell(int x, int y) const {
+  int column = (x - origin_x_ + grid_width_) % grid_width_;
+  int row = (y - origin_y_ + grid_height_) % grid_height_;
+  if (column >= columns_ || row >= rows_) {
+    return -1;
+  }
+  return row * columns_ + column;
+}
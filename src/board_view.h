@@ -0,0 +1,88 @@
+#ifndef BOARD_VIEW_H
+#define BOARD_VIEW_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "sdl_types.h"
+#include "player_snake.h"
+#include "ai_snake.h"
+
+// What a player sees of the board: which cells are on screen, how large
+// they are drawn and which colour each one is. Shared by Renderer and
+// SoftwareRenderer, so a recording shows exactly what the window shows.
+class BoardView {
+ public:
+  enum Colour : std::uint8_t { kBackground, kFood, kPlayer, kAI, kDeadHead, kColourCount };
+  static constexpr SDL_Color kPalette[kColourCount] = {
+      {0x1E, 0x1E, 0x1E, 0xFF},  // background
+      {0xFF, 0xCC, 0x00, 0xFF},  // food
+      {0x00, 0x7A, 0xCC, 0xFF},  // player snake
+      {0xFF, 0x00, 0x00, 0xFF},  // AI snakes
+      {0x80, 0x80, 0x80, 0xFF},  // dead snake's head
+  };
+
+  // A live snake's head drawn part way between cells; see Update.
+  struct HeadMarker {
+    SDL_Rect rect;
+    Colour colour;
+  };
+
+  BoardView(std::size_t screen_width, std::size_t screen_height, std::size_t grid_width,
+            std::size_t grid_height);
+
+  // Zoom in powers of two, from 1 to kMaxCellSize pixels per cell. The board
+  // starts scaled to fit the screen, unless that would leave cells smaller
+  // than kMinFitCellSize; whenever it does not fit, the view scrolls to
+  // keep the player's head centred, wrapping around the board edges.
+  void ZoomIn();
+  void ZoomOut();
+  int CellSize() const { return cell_size_; }
+
+  // Moves the view with the player and works out the colour of every cell
+  // in it. |owners| is Game's owner-id grid, indexed by y * grid_width + x;
+  // only the cells in view are looked up, so the cost depends on the screen
+  // size rather than the board or snake lengths.
+  //
+  // |alpha| is how far real time has got from the last tick to the next,
+  // from 0 to 1. Each live snake also gets a cell-sized head marker at its
+  // head position (SnakeBase::GetHeadPositionX/Y) interpolated over the last
+  // tick: it covers the head cell as the head enters it and slides on toward
+  // the next cell, so heads move smoothly however few ticks there are per
+  // frame.
+  void Update(PlayerSnake const &player_snake,
+              std::vector<std::shared_ptr<AISnake>> const &ai_snakes, SDL_Point const &food,
+              std::vector<std::uint16_t> const &owners, float alpha = 1.0f);
+
+  // Cells in view, and their colours row-major from the top-left cell.
+  // Cell (column, row) covers pixels from (column, row) * CellSize().
+  int Columns() const { return columns_; }
+  int Rows() const { return rows_; }
+  const std::vector<std::uint8_t> &Colours() const { return colours_; }
+  // Head markers in screen pixels, clipped to the cells in view; drawn over
+  // the cells.
+  const std::vector<HeadMarker> &Heads() const { return heads_; }
+
+ private:
+  static constexpr int kMinFitCellSize = 4;
+  static constexpr int kDefaultCellSize = 8;
+  static constexpr int kMaxCellSize = 64;
+
+  int screen_width_;
+  int screen_height_;
+  int grid_width_;
+  int grid_height_;
+  int cell_size_;
+  // Grid cell drawn at the top-left corner.
+  int origin_x_{0};
+  int origin_y_{0};
+  int columns_{0};
+  int rows_{0};
+  std::vector<std::uint8_t> colours_;
+  std::vector<HeadMarker> heads_;
+
+  int ViewCell(int x, int y) const;
+  void AddHeadMarker(const SnakeBase &snake, Colour colour, float alpha);
+};
+
+#endif
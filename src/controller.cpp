@@ -1,32 +1,121 @@
 #include "controller.h"
 #include <iostream>
 #include "SDL.h"
+#include "game.h"
 
-void Controller::HandleInput(bool &running, PlayerSnake &snake) const {
+Controller::Controller() { SDL_AddEventWatch(&Controller::WatchEvent, this); }
+
+Controller::~Controller() { SDL_DelEventWatch(&Controller::WatchEvent, this); }
+
+bool Controller::Apply(const Game &game, PlayerSnake &snake) {
+  bool running = true;
+  // Polling pumps the event loop, which runs the watch for any new presses.
+  HandleInput(running);
+  ApplyTurns(game, snake);
+  return running;
+}
+
+// Runs inside SDL_PumpEvents, on whichever thread pumped, for every event
+// before it is queued.
+int Controller::WatchEvent(void *userdata, SDL_Event *event) {
+  if (event->type != SDL_KEYDOWN || event->key.repeat) {
+    return 1;
+  }
+  TimedTurn turn{SnakeBase::Direction::kUp, std::chrono::steady_clock::now()};
+  switch (event->key.keysym.sym) {
+    case SDLK_UP:
+      turn.direction = SnakeBase::Direction::kUp;
+      break;
+    case SDLK_DOWN:
+      turn.direction = SnakeBase::Direction::kDown;
+      break;
+    case SDLK_LEFT:
+      turn.direction = SnakeBase::Direction::kLeft;
+      break;
+    case SDLK_RIGHT:
+      turn.direction = SnakeBase::Direction::kRight;
+      break;
+    default:
+      return 1;
+  }
+  static_cast<Controller *>(userdata)->turns_.TryPush(turn);
+  return 1;
+}
+
+// Applies queued turns in press order. A turn that would not change the
+// direction, or would reverse into the body, is dropped; otherwise at most
+// one turn is applied per cell, so the second half of a double turn waits
+// for the head to step out of the cell where the first was taken.
+void Controller::ApplyTurns(const Game &game, PlayerSnake &snake) {
+  if (game.GetRoundsPlayed() != round_) {
+    // Presses from the last round do not carry over to a fresh snake.
+    round_ = game.GetRoundsPlayed();
+    pending_.clear();
+    turn_cell_ = {-1, -1};
+  }
+
+  TimedTurn turn;
+  while (turns_.TryPop(turn)) {
+    if (pending_.size() < kMaxPendingTurns) {
+      pending_.push_back(turn);
+    }
+  }
+
+  SDL_Point cell = snake.GetHeadCell();
+  while (!pending_.empty()) {
+    const TimedTurn &next = pending_.front();
+    SnakeBase::Direction opposite = SnakeBase::Opposite(next.direction);
+    if (next.direction == snake.direction || (snake.direction == opposite && snake.size > 1)) {
+      pending_.pop_front();
+      continue;
+    }
+    if (cell.x == turn_cell_.x && cell.y == turn_cell_.y) {
+      break;
+    }
+
+    snake.ChangeDirection(next.direction, opposite);
+    turn_cell_ = cell;
+    std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - next.pressed;
+    latency_.Record(latency.count());
+    if (profiler_) {
+      profiler_->Record(FrameProfiler::Phase::kInputLatency, latency);
+    }
+    pending_.pop_front();
+  }
+}
+
+void Controller::HandleInput(bool &running) {
   SDL_Event e;
   while (SDL_PollEvent(&e)) {
     if (e.type == SDL_QUIT) {
       running = false;
+    } else if (e.type == SDL_WINDOWEVENT || e.type == SDL_RENDER_TARGETS_RESET) {
+      // The window or the board texture may have lost its contents.
+      if (renderer_) {
+        renderer_->Invalidate();
+      }
     } else if (e.type == SDL_KEYDOWN) {
+      // Arrow keys were already queued by WatchEvent.
       switch (e.key.keysym.sym) {
-        case SDLK_UP:
-          snake.ChangeDirection(PlayerSnake::Direction::kUp,
-                          PlayerSnake::Direction::kDown);
-          break;
-
-        case SDLK_DOWN:
-          snake.ChangeDirection(PlayerSnake::Direction::kDown,
-                          PlayerSnake::Direction::kUp);
+        case SDLK_EQUALS:
+        case SDLK_PLUS:
+        case SDLK_KP_PLUS:
+          if (renderer_) {
+            renderer_->ZoomIn();
+          }
           break;
 
-        case SDLK_LEFT:
-          snake.ChangeDirection(PlayerSnake::Direction::kLeft,
-                          PlayerSnake::Direction::kRight);
+        case SDLK_MINUS:
+        case SDLK_KP_MINUS:
+          if (renderer_) {
+            renderer_->ZoomOut();
+          }
           break;
 
-        case SDLK_RIGHT:
-          snake.ChangeDirection(PlayerSnake::Direction::kRight,
-                          PlayerSnake::Direction::kLeft);
+        case SDLK_F12:
+          if (profiler_) {
+            profiler_->WriteCsv();
+          }
           break;
       }
     }
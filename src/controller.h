@@ -1,11 +1,61 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <chrono>
+#include <cstdint>
+#include "SDL.h"
 #include "player_snake.h"
+#include "input_policy.h"
+#include "frame_profiler.h"
+#include "renderer.h"
+#include "ring_buffer.h"
+#include "spsc_queue.h"
 
-class Controller {
+// Keyboard input for the windowed game. Arrow keys are caught by an SDL
+// event watch the moment SDL pumps them, stamped, and pushed onto a
+// lock-free queue; Apply() drains it once per tick and applies the turns in
+// order, one per cell the head enters, so a quick double turn is not lost to
+// the second press overwriting the first. Everything else is polled.
+class Controller : public InputPolicy {
  public:
-  void HandleInput(bool &running, PlayerSnake &snake) const;
+  Controller();
+  ~Controller();
+  Controller(const Controller &) = delete;
+  Controller &operator=(const Controller &) = delete;
+
+  bool Apply(const Game &game, PlayerSnake &snake) override;
+  // F12 dumps |profiler|'s histograms to CSV while the game is running.
+  void SetProfiler(FrameProfiler *profiler) { profiler_ = profiler; }
+  // +/- zoom |renderer|'s view of the board; window events make it repaint.
+  void SetRenderer(Renderer *renderer) { renderer_ = renderer; }
+  // Time from each key press to the start of the tick that first moves the
+  // head in the new direction, in nanoseconds.
+  const LatencyHistogram &GetInputLatency() const { return latency_; }
+
+ private:
+  struct TimedTurn {
+    SnakeBase::Direction direction;
+    std::chrono::steady_clock::time_point pressed;
+  };
+
+  // Turns queued beyond this are dropped, so mashing keys cannot build up
+  // a backlog that plays out long after the presses.
+  static constexpr std::size_t kMaxPendingTurns = 3;
+
+  FrameProfiler *profiler_{nullptr};
+  Renderer *renderer_{nullptr};
+  // Written by the event watch, read by Apply().
+  SpscQueue<TimedTurn, 64> turns_;
+  // Turns taken off turns_ that wait for the head to enter a new cell.
+  RingBuffer<TimedTurn> pending_;
+  int round_{-1};
+  // Head cell when the last turn was applied; the next waits until it moves.
+  SDL_Point turn_cell_{-1, -1};
+  LatencyHistogram latency_;
+
+  static int WatchEvent(void *userdata, SDL_Event *event);
+  void HandleInput(bool &running);
+  void ApplyTurns(const Game &game, PlayerSnake &snake);
 };
 
 #endif
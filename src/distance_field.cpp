@@ -0,0 +1,167 @@
+#include "distance_field.h"
+
+DistanceField::DistanceField(int grid_width, int grid_height)
+    : grid_width_(grid_width),
+      grid_height_(grid_height),
+      distance_(static_cast<std::size_t>(grid_width) * grid_height, kUnreachable),
+      blocked_(distance_.size(), 0) {}
+
+void DistanceField::Reset(const SDL_Point& goal, const std::vector<std::uint8_t>& blocked) {
+  blocked_ = blocked;
+  goal_ = goal.y * grid_width_ + goal.x;
+  distance_.assign(distance_.size(), kUnreachable);
+  updated_ = 0;
+
+  queue_.clear();
+  if (!blocked_[goal_]) {
+    distance_[goal_] = 0;
+    queue_.push_back(goal_);
+  }
+  Propagate();
+}
+
+bool DistanceField::HasGoal(const SDL_Point& goal) const {
+  return goal_ == goal.y * grid_width_ + goal.x;
+}
+
+void DistanceField::SetCellBlocked(int x, int y, bool blocked) {
+  int cell = y * grid_width_ + x;
+  if ((blocked_[cell] != 0) == blocked) {
+    return;
+  }
+  blocked_[cell] = blocked;
+  updated_ = 0;
+  if (goal_ < 0) {
+    return;
+  }
+
+  if (blocked) {
+    Invalidate(cell);
+    return;
+  }
+
+  // A freed cell can only shorten paths: give it the best distance its
+  // neighbours offer and let that spread.
+  int best = kUnreachable;
+  if (cell == goal_) {
+    best = 0;
+  } else {
+    int neighbors[4];
+    Neighbors(cell, neighbors);
+    for (int neighbor : neighbors) {
+      if (distance_[neighbor] != kUnreachable && distance_[neighbor] + 1 < best) {
+        best = distance_[neighbor] + 1;
+      }
+    }
+  }
+  if (best == kUnreachable) {
+    return;
+  }
+  distance_[cell] = best;
+  updated_++;
+  queue_.clear();
+  queue_.push_back(cell);
+  Propagate();
+}
+
+bool DistanceField::NextStep(const SDL_Point& from, SDL_Point& next) const {
+  int neighbors[4];
+  Neighbors(from.y * grid_width_ + from.x, neighbors);
+  int best = -1;
+  for (int neighbor : neighbors) {
+    if (blocked_[neighbor] || distance_[neighbor] == kUnreachable) continue;
+    if (best < 0 || distance_[neighbor] < distance_[best]) {
+      best = neighbor;
+    }
+  }
+  if (best < 0) {
+    return false;
+  }
+  next = {best % grid_width_, best / grid_width_};
+  return true;
+}
+
+// Relaxes distances outward from the cells in queue_. A cell may be queued
+// more than once when several seeds reach it, which keeps the repair correct
+// even when the seeds start at different distances.
+void DistanceField::Propagate() {
+  int neighbors[4];
+  for (std::size_t head = 0; head < queue_.size(); ++head) {
+    int cell = queue_[head];
+    int next_distance = distance_[cell] + 1;
+    Neighbors(cell, neighbors);
+    for (int neighbor : neighbors) {
+      if (blocked_[neighbor] || distance_[neighbor] <= next_distance) continue;
+      distance_[neighbor] = next_distance;
+      queue_.push_back(neighbor);
+      updated_++;
+    }
+  }
+}
+
+// Handles a newly blocked cell. Every cell that has lost its last neighbour
+// one step closer to the goal is reset, then the reset region is refilled
+// from its surviving border.
+void DistanceField::Invalidate(int cell) {
+  if (distance_[cell] == kUnreachable) {
+    return;
+  }
+  distance_[cell] = kUnreachable;
+
+  int neighbors[4];
+  invalidated_.clear();
+  queue_.clear();
+  queue_.push_back(cell);
+  for (std::size_t head = 0; head < queue_.size(); ++head) {
+    int parent = queue_[head];
+    Neighbors(parent, neighbors);
+    for (int child : neighbors) {
+      if (blocked_[child] || child == goal_ || distance_[child] == kUnreachable) continue;
+      int supporting = distance_[child] - 1;
+      int child_neighbors[4];
+      Neighbors(child, child_neighbors);
+      bool supported = false;
+      for (int candidate : child_neighbors) {
+        if (distance_[candidate] == supporting) {
+          supported = true;
+          break;
+        }
+      }
+      if (!supported) {
+        distance_[child] = kUnreachable;
+        invalidated_.push_back(child);
+        queue_.push_back(child);
+      }
+    }
+  }
+
+  queue_.clear();
+  for (int orphan : invalidated_) {
+    Neighbors(orphan, neighbors);
+    int best = kUnreachable;
+    for (int neighbor : neighbors) {
+      if (distance_[neighbor] != kUnreachable && distance_[neighbor] + 1 < best) {
+        best = distance_[neighbor] + 1;
+      }
+    }
+    if (best != kUnreachable) {
+      distance_[orphan] = best;
+      queue_.push_back(orphan);
+    }
+  }
+  updated_ += invalidated_.size();
+  Propagate();
+}
+
+void DistanceField::Neighbors(int cell, int (&neighbors)[4]) const {
+  int x = cell % grid_width_;
+  int y = cell / grid_width_;
+  int up = (y + grid_height_ - 1) % grid_height_;
+  int down = (y + 1) % grid_height_;
+  int left = (x + grid_width_ - 1) % grid_width_;
+  int right = (x + 1) % grid_width_;
+  neighbors[0] = up * grid_width_ + x;
+  neighbors[1] = down * grid_width_ + x;
+  neighbors[2] = y * grid_width_ + left;
+  neighbors[3] = y * grid_width_ + right;
+}
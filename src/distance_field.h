@@ -0,0 +1,51 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "sdl_types.h"
+
+// Breadth-first distance from every cell of the wrap-around grid to a single
+// goal, avoiding blocked cells. It answers "which way to the food" for any
+// number of snakes with a lookup of the four neighbouring cells, and is kept
+// up to date as cells are blocked and freed instead of being recomputed.
+class DistanceField {
+ public:
+  static constexpr int kUnreachable = std::numeric_limits<int>::max();
+
+  DistanceField(int grid_width, int grid_height);
+
+  // Recomputes the whole field for a new goal. |blocked| is non-zero for
+  // occupied cells, indexed by y * grid_width + x, and is copied.
+  void Reset(const SDL_Point& goal, const std::vector<std::uint8_t>& blocked);
+  bool HasGoal(const SDL_Point& goal) const;
+
+  // Repairs only the distances that depend on the changed cell.
+  void SetCellBlocked(int x, int y, bool blocked);
+
+  int Distance(int x, int y) const { return distance_[y * grid_width_ + x]; }
+  // Free neighbour of |from| that is closest to the goal. False if none of
+  // them can reach it.
+  bool NextStep(const SDL_Point& from, SDL_Point& next) const;
+
+  // Cells whose distance was rewritten by the last Reset or SetCellBlocked.
+  int GetLastUpdated() const { return updated_; }
+
+ private:
+  int grid_width_;
+  int grid_height_;
+  int goal_{-1};
+  int updated_{0};
+  std::vector<int> distance_;
+  std::vector<std::uint8_t> blocked_;
+  // Reusable work lists, so updates do not allocate.
+  std::vector<int> queue_;
+  std::vector<int> invalidated_;
+
+  void Propagate();
+  void Invalidate(int cell);
+  void Neighbors(int cell, int (&neighbors)[4]) const;
+};
+
+#endif
@@ -0,0 +1,245 @@
+#include "dstar_lite.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr int kInfinity = 1 << 29;
+
+int AddCost(int a, int b) {
+  return (a >= kInfinity || b >= kInfinity) ? kInfinity : a + b;
+}
+
+}  // namespace
+
+DStarLite::DStarLite(int grid_width, int grid_height)
+    : grid_width_(grid_width),
+      grid_height_(grid_height),
+      cells_(static_cast<std::size_t>(grid_width) * grid_height),
+      blocked_(cells_.size(), 0) {}
+
+void DStarLite::Reset(const SDL_Point& start, const SDL_Point& goal,
+                      const std::vector<std::uint8_t>& blocked) {
+  if (++generation_ == 0) {
+    for (auto& cell : cells_) cell.generation = 0;
+    generation_ = 1;
+  }
+  heap_.clear();
+  blocked_ = blocked;
+  start_ = start.y * grid_width_ + start.x;
+  goal_ = goal.y * grid_width_ + goal.x;
+  last_start_ = start_;
+  km_ = 0;
+
+  State(goal_).rhs = 0;
+  Push(goal_);
+}
+
+bool DStarLite::HasGoal(const SDL_Point& goal) const {
+  return goal_ == goal.y * grid_width_ + goal.x;
+}
+
+void DStarLite::SetCellBlocked(int x, int y, bool blocked) {
+  int cell = y * grid_width_ + x;
+  if ((blocked_[cell] != 0) == blocked) {
+    return;
+  }
+  blocked_[cell] = blocked;
+  if (goal_ < 0) {
+    return;
+  }
+
+  // Only the edges leading into |cell| changed cost.
+  int neighbors[4];
+  Neighbors(cell, neighbors);
+  for (int neighbor : neighbors) {
+    UpdateVertex(neighbor);
+  }
+}
+
+void DStarLite::MoveStart(const SDL_Point& start) {
+  int cell = start.y * grid_width_ + start.x;
+  if (cell == start_) {
+    return;
+  }
+  km_ += Heuristic(last_start_, cell);
+  last_start_ = cell;
+  start_ = cell;
+}
+
+bool DStarLite::ComputePath() {
+  expanded_ = 0;
+  if (goal_ < 0) {
+    return false;
+  }
+
+  int neighbors[4];
+  while (true) {
+    PopStale();
+    if (heap_.empty()) {
+      break;
+    }
+    HeapEntry top = heap_.front();
+    if (!(top.key < CalculateKey(start_)) && Rhs(start_) == G(start_)) {
+      break;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), HeapOrder);
+    heap_.pop_back();
+    int u = top.cell;
+    CellState& state = State(u);
+    state.open = false;
+    expanded_++;
+
+    Key new_key = CalculateKey(u);
+    if (top.key < new_key) {
+      Push(u);
+      continue;
+    }
+
+    if (state.g > state.rhs) {
+      state.g = state.rhs;
+    } else {
+      state.g = kInfinity;
+      UpdateVertex(u);
+    }
+
+    // Predecessors reach |u| only if it can be entered.
+    if (!blocked_[u]) {
+      Neighbors(u, neighbors);
+      for (int neighbor : neighbors) {
+        UpdateVertex(neighbor);
+      }
+    }
+  }
+
+  return G(start_) < kInfinity;
+}
+
+bool DStarLite::NextStep(SDL_Point& next) const {
+  if (goal_ < 0) {
+    return false;
+  }
+
+  int neighbors[4];
+  Neighbors(start_, neighbors);
+  int best = -1;
+  int best_cost = kInfinity;
+  for (int neighbor : neighbors) {
+    if (blocked_[neighbor]) continue;
+    int cost = AddCost(1, G(neighbor));
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = neighbor;
+    }
+  }
+  if (best < 0) {
+    return false;
+  }
+  next = {best % grid_width_, best / grid_width_};
+  return true;
+}
+
+DStarLite::CellState& DStarLite::State(int cell) {
+  CellState& state = cells_[cell];
+  if (state.generation != generation_) {
+    state.g = kInfinity;
+    state.rhs = kInfinity;
+    state.open = false;
+    state.generation = generation_;
+  }
+  return state;
+}
+
+int DStarLite::G(int cell) const {
+  const CellState& state = cells_[cell];
+  return state.generation == generation_ ? state.g : kInfinity;
+}
+
+int DStarLite::Rhs(int cell) const {
+  const CellState& state = cells_[cell];
+  return state.generation == generation_ ? state.rhs : kInfinity;
+}
+
+DStarLite::Key DStarLite::CalculateKey(int cell) const {
+  int m = std::min(G(cell), Rhs(cell));
+  if (m >= kInfinity) {
+    return {kInfinity, kInfinity};
+  }
+  return {m + Heuristic(start_, cell) + km_, m};
+}
+
+int DStarLite::Heuristic(int a, int b) const {
+  int dx = std::abs(a % grid_width_ - b % grid_width_);
+  int dy = std::abs(a / grid_width_ - b / grid_width_);
+  return std::min(dx, grid_width_ - dx) + std::min(dy, grid_height_ - dy);
+}
+
+void DStarLite::UpdateVertex(int cell) {
+  CellState& state = State(cell);
+  if (cell != goal_) {
+    int neighbors[4];
+    Neighbors(cell, neighbors);
+    int rhs = kInfinity;
+    for (int neighbor : neighbors) {
+      if (blocked_[neighbor]) continue;
+      rhs = std::min(rhs, AddCost(1, G(neighbor)));
+    }
+    state.rhs = rhs;
+  }
+
+  // Removal is lazy: clearing |open| invalidates any heap entry for the cell.
+  state.open = false;
+  if (state.g != state.rhs) {
+    Push(cell);
+  }
+}
+
+void DStarLite::Push(int cell) {
+  // Stale entries pile up between pops; compact once they dominate.
+  if (heap_.size() > 4 * cells_.size() + 64) {
+    heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+                               [this](const HeapEntry& entry) {
+                                 const CellState& state = cells_[entry.cell];
+                                 return !state.open || !(state.open_key == entry.key);
+                               }),
+                heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), HeapOrder);
+  }
+
+  CellState& state = State(cell);
+  state.open = true;
+  state.open_key = CalculateKey(cell);
+  heap_.push_back({state.open_key, cell});
+  std::push_heap(heap_.begin(), heap_.end(), HeapOrder);
+}
+
+void DStarLite::PopStale() {
+  while (!heap_.empty()) {
+    const HeapEntry& top = heap_.front();
+    const CellState& state = cells_[top.cell];
+    if (state.generation == generation_ && state.open && state.open_key == top.key) {
+      return;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), HeapOrder);
+    heap_.pop_back();
+  }
+}
+
+void DStarLite::Neighbors(int cell, int (&neighbors)[4]) const {
+  int x = cell % grid_width_;
+  int y = cell / grid_width_;
+  int up = (y + grid_height_ - 1) % grid_height_;
+  int down = (y + 1) % grid_height_;
+  int left = (x + grid_width_ - 1) % grid_width_;
+  int right = (x + 1) % grid_width_;
+  neighbors[0] = up * grid_width_ + x;
+  neighbors[1] = down * grid_width_ + x;
+  neighbors[2] = y * grid_width_ + left;
+  neighbors[3] = y * grid_width_ + right;
+}
+
+// Min-heap on the two-part D* Lite key.
+bool DStarLite::HeapOrder(const HeapEntry& a, const HeapEntry& b) {
+  return b.key < a.key;
+}
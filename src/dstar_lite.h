@@ -0,0 +1,86 @@
+#ifndef DSTAR_LITE_H
+#define DSTAR_LITE_H
+
+#include <cstdint>
+#include <vector>
+#include "sdl_types.h"
+
+// Incremental shortest-path planner (D* Lite, Koenig & Likhachev) on the
+// wrap-around 4-connected grid. The search runs backward from the goal, so
+// when the start moves or individual cells become blocked or free, only the
+// part of the search tree affected by the change is repaired. Entering a
+// blocked cell costs infinity; leaving one is allowed, so the snake's own
+// head cell never traps the search.
+class DStarLite {
+ public:
+  DStarLite(int grid_width, int grid_height);
+
+  // Starts over for a new goal. |blocked| is non-zero for occupied cells,
+  // indexed by y * grid_width + x, and is copied into the planner.
+  void Reset(const SDL_Point& start, const SDL_Point& goal,
+             const std::vector<std::uint8_t>& blocked);
+  bool HasGoal(const SDL_Point& goal) const;
+
+  // Records a change to one cell; repaired on the next ComputePath().
+  void SetCellBlocked(int x, int y, bool blocked);
+  void MoveStart(const SDL_Point& start);
+
+  // Brings the search up to date. Returns false if the goal is unreachable
+  // from the start.
+  bool ComputePath();
+  // Best neighbour to step to from the start, once ComputePath() succeeded.
+  bool NextStep(SDL_Point& next) const;
+
+  // Cells expanded by the last ComputePath().
+  int GetLastExpanded() const { return expanded_; }
+
+ private:
+  struct Key {
+    int k1;
+    int k2;
+    bool operator<(const Key& other) const {
+      return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2);
+    }
+    bool operator==(const Key& other) const { return k1 == other.k1 && k2 == other.k2; }
+  };
+
+  struct HeapEntry {
+    Key key;
+    int cell;
+  };
+
+  // g/rhs are only meaningful when generation matches generation_, so Reset
+  // does not have to touch every cell.
+  struct CellState {
+    int g;
+    int rhs;
+    Key open_key;
+    unsigned int generation{0};
+    bool open{false};
+  };
+
+  int grid_width_;
+  int grid_height_;
+  std::vector<CellState> cells_;
+  std::vector<std::uint8_t> blocked_;
+  std::vector<HeapEntry> heap_;
+  unsigned int generation_{0};
+  int start_{-1};
+  int goal_{-1};
+  int last_start_{-1};
+  int km_{0};
+  int expanded_{0};
+
+  CellState& State(int cell);
+  int G(int cell) const;
+  int Rhs(int cell) const;
+  Key CalculateKey(int cell) const;
+  int Heuristic(int a, int b) const;
+  void UpdateVertex(int cell);
+  void Push(int cell);
+  void PopStale();
+  void Neighbors(int cell, int (&neighbors)[4]) const;
+  static bool HeapOrder(const HeapEntry& a, const HeapEntry& b);
+};
+
+#endif
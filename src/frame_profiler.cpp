@@ -0,0 +1,135 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// Buckets 0..kSubBuckets-1 hold exact values; after that each power of two
+// (up to 2^63) gets kSubBuckets more.
+constexpr int kBucketCount = (64 - LatencyHistogram::kSubBucketBits + 1) * LatencyHistogram::kSubBuckets;
+
+int HighestBit(std::uint64_t value) {
+  return 63 - __builtin_clzll(value);
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() : buckets_(kBucketCount, 0) {}
+
+void LatencyHistogram::Record(std::uint64_t value) {
+  buckets_[BucketIndex(value)]++;
+  count_++;
+  sum_ += value;
+  if (value > max_) max_ = value;
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+double LatencyHistogram::Mean() const {
+  return count_ ? static_cast<double>(sum_) / count_ : 0.0;
+}
+
+std::uint64_t LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) return 0;
+
+  std::uint64_t target = static_cast<std::uint64_t>(percentile / 100.0 * count_ + 0.5);
+  if (target == 0) target = 1;
+  std::uint64_t seen = 0;
+  for (int i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      return std::min(BucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+int LatencyHistogram::BucketIndex(std::uint64_t value) {
+  if (value < kSubBuckets) return static_cast<int>(value);
+  int shift = HighestBit(value) - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + static_cast<int>((value >> shift) - kSubBuckets);
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(int index) {
+  if (index < kSubBuckets) return index;
+  int shift = index / kSubBuckets - 1;
+  std::uint64_t sub = index % kSubBuckets + kSubBuckets;
+  return ((sub + 1) << shift) - 1;
+}
+
+FrameProfiler::FrameProfiler(std::string csv_path) : csv_path_(std::move(csv_path)) {}
+
+void FrameProfiler::Record(Phase phase, std::chrono::nanoseconds duration) {
+  histograms_[static_cast<int>(phase)].Record(duration.count());
+}
+
+void FrameProfiler::Record(Counter counter, std::uint64_t value) {
+  counters_[static_cast<int>(counter)].Record(value);
+}
+
+const LatencyHistogram &FrameProfiler::Histogram(Phase phase) const {
+  return histograms_[static_cast<int>(phase)];
+}
+
+const LatencyHistogram &FrameProfiler::Histogram(Counter counter) const {
+  return counters_[static_cast<int>(counter)];
+}
+
+bool FrameProfiler::WriteCsv() const {
+  std::ofstream out(csv_path_);
+  if (!out) {
+    std::cerr << "Could not write frame timings to " << csv_path_ << "\n";
+    return false;
+  }
+
+  out << "phase,count,mean_us,p50_us,p99_us,p99_9_us,max_us\n";
+  for (int i = 0; i < static_cast<int>(Phase::kCount); ++i) {
+    const LatencyHistogram &histogram = histograms_[i];
+    out << PhaseName(static_cast<Phase>(i)) << ',' << histogram.Count() << ','
+        << histogram.Mean() / 1000.0 << ','
+        << histogram.Percentile(50.0) / 1000.0 << ','
+        << histogram.Percentile(99.0) / 1000.0 << ','
+        << histogram.Percentile(99.9) / 1000.0 << ','
+        << histogram.Max() / 1000.0 << '\n';
+  }
+
+  out << "\ncounter,count,mean,p50,p99,p99_9,max\n";
+  for (int i = 0; i < static_cast<int>(Counter::kCount); ++i) {
+    const LatencyHistogram &histogram = counters_[i];
+    out << CounterName(static_cast<Counter>(i)) << ',' << histogram.Count() << ','
+        << histogram.Mean() << ',' << histogram.Percentile(50.0) << ','
+        << histogram.Percentile(99.0) << ',' << histogram.Percentile(99.9) << ','
+        << histogram.Max() << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+const char *FrameProfiler::PhaseName(Phase phase) {
+  switch (phase) {
+    case Phase::kInput: return "input";
+    case Phase::kUpdate: return "update";
+    case Phase::kCollisions: return "collisions";
+    case Phase::kPlaceFood: return "place_food";
+    case Phase::kRender: return "render";
+    case Phase::kPresent: return "present";
+    case Phase::kFrame: return "frame";
+    case Phase::kInputLatency: return "input_latency";
+    case Phase::kCount: break;
+  }
+  return "unknown";
+}
+
+const char *FrameProfiler::CounterName(Counter counter) {
+  switch (counter) {
+    case Counter::kDrawCalls: return "draw_calls";
+    case Counter::kRects: return "rects";
+    case Counter::kCount: break;
+  }
+  return "unknown";
+}
@@ -0,0 +1,100 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Log-linear latency histogram in the style of HdrHistogram: every power of
+// two is split into kSubBuckets linear buckets, so any recorded value is
+// reported within 1/kSubBuckets (~3%) of its true value. Recording is O(1)
+// and never allocates.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+
+  LatencyHistogram();
+
+  void Record(std::uint64_t value);
+  void Reset();
+
+  std::uint64_t Count() const { return count_; }
+  std::uint64_t Max() const { return max_; }
+  double Mean() const;
+  // Smallest bucket upper bound that covers |percentile| (0-100) of samples.
+  std::uint64_t Percentile(double percentile) const;
+
+ private:
+  std::vector<std::uint64_t> buckets_;
+  std::uint64_t count_{0};
+  std::uint64_t sum_{0};
+  std::uint64_t max_{0};
+
+  static int BucketIndex(std::uint64_t value);
+  static std::uint64_t BucketUpperBound(int index);
+};
+
+// Per-phase frame timing. Game::Run, Game::Update and Renderer record into it
+// through ScopedPhaseTimer when a profiler is attached.
+class FrameProfiler {
+ public:
+  // kInputLatency is not a phase of the frame but the time from a key press
+  // to the tick that acts on it.
+  enum class Phase {
+    kInput,
+    kUpdate,
+    kCollisions,
+    kPlaceFood,
+    kRender,
+    kPresent,
+    kFrame,
+    kInputLatency,
+    kCount
+  };
+  // Per-frame quantities that are not times.
+  enum class Counter { kDrawCalls, kRects, kCount };
+
+  explicit FrameProfiler(std::string csv_path);
+
+  void Record(Phase phase, std::chrono::nanoseconds duration);
+  void Record(Counter counter, std::uint64_t value);
+  const LatencyHistogram &Histogram(Phase phase) const;
+  const LatencyHistogram &Histogram(Counter counter) const;
+
+  // Writes count, mean and p50/p99/p99.9/max per phase (in microseconds),
+  // then the same columns per counter, to the CSV path given at
+  // construction. Returns false if the file could not be written.
+  bool WriteCsv() const;
+
+ private:
+  std::string csv_path_;
+  std::array<LatencyHistogram, static_cast<int>(Phase::kCount)> histograms_;
+  std::array<LatencyHistogram, static_cast<int>(Counter::kCount)> counters_;
+
+  static const char *PhaseName(Phase phase);
+  static const char *CounterName(Counter counter);
+};
+
+class ScopedPhaseTimer {
+ public:
+  ScopedPhaseTimer(FrameProfiler *profiler, FrameProfiler::Phase phase)
+      : profiler_(profiler), phase_(phase) {
+    if (profiler_) start_ = std::chrono::steady_clock::now();
+  }
+  ~ScopedPhaseTimer() {
+    if (profiler_) profiler_->Record(phase_, std::chrono::steady_clock::now() - start_);
+  }
+
+  ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+  ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+ private:
+  FrameProfiler *profiler_;
+  FrameProfiler::Phase phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef FREE_CELL_SET_H
+#define FREE_CELL_SET_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// The set of empty cells as a dense array plus each cell's position in it.
+// Insert appends, Erase moves the last element into the gap, and Pick draws
+// a uniform member with one random number, all in O(1) however full the
+// board is.
+class FreeCellSet {
+ public:
+  explicit FreeCellSet(std::size_t cell_count)
+      : position_(cell_count, kAbsent) {
+    cells_.reserve(cell_count);
+  }
+
+  // Makes every cell free.
+  void Fill() {
+    cells_.resize(position_.size());
+    for (std::size_t i = 0; i < cells_.size(); ++i) {
+      cells_[i] = static_cast<int>(i);
+      position_[i] = static_cast<std::uint32_t>(i);
+    }
+  }
+
+  void Insert(int cell) {
+    if (position_[cell] != kAbsent) return;
+    position_[cell] = static_cast<std::uint32_t>(cells_.size());
+    cells_.push_back(cell);
+  }
+
+  void Erase(int cell) {
+    std::uint32_t index = position_[cell];
+    if (index == kAbsent) return;
+    int last = cells_.back();
+    cells_[index] = last;
+    position_[last] = index;
+    cells_.pop_back();
+    position_[cell] = kAbsent;
+  }
+
+  bool Contains(int cell) const { return position_[cell] != kAbsent; }
+  std::size_t Size() const { return cells_.size(); }
+  bool Empty() const { return cells_.empty(); }
+
+  // A uniformly chosen free cell. The set must not be empty.
+  template <typename Engine>
+  int Pick(Engine &engine) const {
+    std::uniform_int_distribution<std::size_t> index(0, cells_.size() - 1);
+    return cells_[index(engine)];
+  }
+
+ private:
+  static constexpr std::uint32_t kAbsent = UINT32_MAX;
+
+  std::vector<int> cells_;
+  // Index of each cell in cells_, or kAbsent while the cell is occupied.
+  std::vector<std::uint32_t> position_;
+};
+
+#endif
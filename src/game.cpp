@@ -1,19 +1,53 @@
 #include "game.h"
+#include <algorithm>
 #include <iostream>
-#include "SDL.h"
+#include "state_hash.h"
+
+namespace {
+
+// Speed a snake gains per food eaten: 0.02 cells per tick at the base rate.
+constexpr std::int32_t kSpeedPerFood = SnakeBase::kCellUnits / 50;
+
+GameConfig MakeConfig(std::size_t grid_width, std::size_t grid_height) {
+  GameConfig config;
+  config.grid_width = grid_width;
+  config.grid_height = grid_height;
+  return config;
+}
+
+}  // namespace
 
 Game::Game(std::size_t grid_width, std::size_t grid_height)
-    : grid_width_(grid_width), grid_height_(grid_height),
-      engine(dev()),
-      random_w(0, static_cast<int>(grid_width - 1)),
-      random_h(0, static_cast<int>(grid_height - 1)) {
-  player_snake_ = std::make_shared<PlayerSnake>(grid_width, grid_height);
-  ai_snake_ = std::make_shared<AISnake>(grid_width, grid_height);
-  game_state_ = std::make_shared<GameState>(grid_width, grid_height);
-  pathfinding_thread_ = std::make_unique<PathfindingThread>(game_state_);
-  
+    : Game(MakeConfig(grid_width, grid_height)) {}
+
+Game::Game(const GameConfig &config)
+    : config_(config),
+      engine(config.seed ? *config.seed : std::random_device{}()),
+      grid_width_(config.grid_width),
+      grid_height_(config.grid_height),
+      grid_(config.grid_width, config.grid_height),
+      free_cells_(config.grid_width, config.grid_height),
+      free_set_(config.grid_width * config.grid_height) {
+  game_state_ = std::make_shared<GameState>(grid_width_, grid_height_);
+  if (config_.async_pathfinding && config_.ai_planner == AIPlanner::kAStar) {
+    pathfinding_thread_ = std::make_unique<PathfindingThread>(game_state_, config_.ai_pathfinder);
+  }
+  if (config_.ai_planner == AIPlanner::kDistanceField) {
+    distance_field_ = std::make_unique<DistanceField>(grid_width_, grid_height_);
+  }
+  if (config_.ai_planner == AIPlanner::kMcts) {
+    mcts_ = std::make_unique<MctsPlanner>(grid_width_, grid_height_, config_.mcts, engine());
+  }
+  if (config_.ai_avoid_traps) {
+    space_search_ = std::make_unique<BitBoardSearch>(grid_width_, grid_height_);
+  }
+  SpawnSnakes();
+
   PlaceFood();
-  pathfinding_thread_->Start();
+  if (pathfinding_thread_) {
+    pathfinding_thread_->Start();
+    FinishTick();
+  }
 }
 
 Game::~Game() {
@@ -22,159 +56,372 @@ Game::~Game() {
   }
 }
 
-void Game::Run(Controller const &controller, Renderer &renderer,
-               std::size_t target_frame_duration) {
-  Uint32 title_timestamp = SDL_GetTicks();
-  Uint32 frame_start;
-  Uint32 frame_end;
-  Uint32 frame_duration;
-  int frame_count = 0;
-  bool running = true;
-
-  while (running && game_state_->game_running) {
-    frame_start = SDL_GetTicks();
-
-    // Input, Update, Render - the main game loop.
-    controller.HandleInput(running, *player_snake_);
-    Update();
-    renderer.Render(*player_snake_, *ai_snake_, food);
-
-    frame_end = SDL_GetTicks();
-
-    // Keep track of how long each loop through the input/update/render cycle
-    // takes.
-    frame_count++;
-    frame_duration = frame_end - frame_start;
-
-    // After every second, update the window title.
-    if (frame_end - title_timestamp >= 1000) {
-      renderer.UpdateWindowTitle(player_score_, ai_score_, frame_count);
-      frame_count = 0;
-      title_timestamp = frame_end;
-    }
-
-    // If the time for this frame is too small (i.e. frame_duration is
-    // smaller than the target ms_per_frame), delay the loop to
-    // achieve the correct frame rate.
-    if (frame_duration < target_frame_duration) {
-      SDL_Delay(target_frame_duration - frame_duration);
-    }
+// Puts the food on a uniformly chosen free cell. Returns false, and marks
+// the board full, if the snakes cover every cell.
+bool Game::PlaceFood() {
+  ScopedPhaseTimer timer(profiler_, FrameProfiler::Phase::kPlaceFood);
+  if (free_set_.Empty()) {
+    board_full_ = true;
+    return false;
   }
-}
-
-void Game::PlaceFood() {
-  int x, y;
-  while (true) {
-    x = random_w(engine);
-    y = random_h(engine);
-    // Check that the location is not occupied by either snake before placing food.
-    if (!player_snake_->SnakeCell(x, y) && !ai_snake_->SnakeCell(x, y)) {
-      food.x = x;
-      food.y = y;
-      game_state_->UpdateFood(food);
-      pathfinding_thread_->NotifyStateChanged();
-      return;
+  int cell = free_set_.Pick(engine);
+  food.x = grid_.X(cell);
+  food.y = grid_.Y(cell);
+  if (pathfinding_thread_) {
+    replan_pending_ = true;
+  } else {
+    // Without the worker thread the AI is told directly. Snakes only
+    // appear on reset, which always places new food, so this is the
+    // only point where an AI's target can change.
+    for (auto &ai_snake : ai_snakes_) {
+      ai_snake->SetTarget(food);
     }
+    ResetDistanceField();
   }
+  return true;
 }
 
 void Game::Update() {
+  tick_++;
+
   if (!player_snake_->IsAlive()) {
     ResetGame();
+    FinishTick();
     return;
   }
 
+  AdoptWorkerPath();
+  player_snake_->BeginTick();
   player_snake_->Update();
-  ai_snake_->Update();
-  
-  // Update game state
-  game_state_->UpdatePlayerSnake(player_snake_);
-  game_state_->UpdateAISnake(ai_snake_);
+  ApplyMoves(*player_snake_, kPlayerOwner);
+  for (std::size_t i = 0; i < ai_snakes_.size(); ++i) {
+    ai_snakes_[i]->BeginTick();
+    ai_snakes_[i]->Update();
+    ApplyMoves(*ai_snakes_[i], kFirstAIOwner + i);
+  }
   
   HandleCollisions();
 
   // Check if player snake got food
-  int player_x = static_cast<int>(player_snake_->GetHeadX());
-  int player_y = static_cast<int>(player_snake_->GetHeadY());
+  SDL_Point player_head = player_snake_->GetHeadCell();
   
-  if (food.x == player_x && food.y == player_y) {
+  if (food.x == player_head.x && food.y == player_head.y) {
     player_score_++;
     PlaceFood();
     player_snake_->GrowBody();
-    player_snake_->speed += 0.02;
+    player_snake_->speed += kSpeedPerFood;
   }
   
-  // Check if AI snake got food
-  int ai_x = static_cast<int>(ai_snake_->GetHeadX());
-  int ai_y = static_cast<int>(ai_snake_->GetHeadY());
-  
-  if (food.x == ai_x && food.y == ai_y) {
-    ai_score_++;
-    PlaceFood();
-    ai_snake_->GrowBody();
-    ai_snake_->speed += 0.02;  
+  // Check if an AI snake got food
+  for (auto &ai_snake : ai_snakes_) {
+    SDL_Point ai_head = ai_snake->GetHeadCell();
+
+    if (food.x == ai_head.x && food.y == ai_head.y) {
+      ai_score_++;
+      PlaceFood();
+      ai_snake->GrowBody();
+      ai_snake->speed += kSpeedPerFood;
+    }
+  }
+
+  if (board_full_) {
+    ResetGame();
+  }
+
+  SyncBoardChanges();
+  FinishTick();
+}
+
+// Folds the cells |snake| entered or left this tick into the owner grid. A
+// head landing on a cell another snake owns is only recorded here; whether
+// it is a collision depends on the snakes that move after it.
+void Game::ApplyMoves(SnakeBase &snake, std::uint16_t owner) {
+  for (const SDL_Point &point : snake.GetChangedCells()) {
+    int cell = grid_.Index(point.x, point.y);
+    if (!snake.SnakeCell(point.x, point.y)) {
+      if (owner_[cell] == owner) SetOwner(cell, 0);
+    } else if (owner_[cell] == 0) {
+      SetOwner(cell, owner);
+    } else if (owner_[cell] != owner) {
+      pending_hits_.push_back({owner, cell});
+    }
+  }
+  snake.ClearChangedCells();
+}
+
+void Game::ClaimCells(const SnakeBase &snake, std::uint16_t owner) {
+  for (const SDL_Point &point : snake.GetBody()) {
+    SetOwner(grid_.Index(point.x, point.y), owner);
   }
+  SDL_Point head = snake.GetHeadCell();
+  SetOwner(grid_.Index(head.x, head.y), owner);
+}
+
+void Game::SetOwner(int cell, std::uint16_t owner) {
+  owner_[cell] = owner;
+  std::uint8_t blocked = owner != 0;
+  if (blocked_[cell] != blocked) {
+    blocked_[cell] = blocked;
+    if (blocked) {
+      free_cells_.Reset(grid_.X(cell), grid_.Y(cell));
+      free_set_.Erase(cell);
+    } else {
+      free_cells_.Set(grid_.X(cell), grid_.Y(cell));
+      free_set_.Insert(cell);
+    }
+    board_changes_.push_back(cell);
+  }
+}
+
+// Hands every cell that became blocked or free this tick to the incremental
+// planners.
+void Game::SyncBoardChanges() {
+  if (distance_field_) {
+    for (int cell : board_changes_) {
+      distance_field_->SetCellBlocked(grid_.X(cell), grid_.Y(cell), blocked_[cell]);
+    }
+  }
+  if (config_.ai_planner == AIPlanner::kIncremental) {
+    for (auto &ai_snake : ai_snakes_) {
+      for (int cell : board_changes_) {
+        ai_snake->OnCellChanged(grid_.X(cell), grid_.Y(cell), blocked_[cell]);
+      }
+    }
+  }
+  board_changes_.clear();
+}
+
+void Game::ResetDistanceField() {
+  if (distance_field_) {
+    distance_field_->Reset(food, blocked_);
+  }
+}
+
+// Publishes this tick's board to the pathfinding thread and wakes it if an
+// AI needs a new path. A no-op when the AI plans inline.
+void Game::FinishTick() {
+  if (!pathfinding_thread_) {
+    return;
+  }
+
+  PublishSnapshot();
+  bool requested = replan_pending_;
+  for (auto &ai_snake : ai_snakes_) {
+    requested = ai_snake->TakeReplanRequest() || requested;
+  }
+  if (requested) {
+    replan_pending_ = false;
+    pathfinding_thread_->NotifyStateChanged();
+  }
+}
+
+void Game::PublishSnapshot() {
+  BoardSnapshot &snapshot = game_state_->BeginSnapshot();
+  snapshot.blocked = blocked_;
+  snapshot.tick = tick_;
+  snapshot.food = food;
+  snapshot.heads.resize(1 + ai_snakes_.size());
+  snapshot.heads[0] = player_snake_->GetHeadCell();
+  for (std::size_t i = 0; i < ai_snakes_.size(); ++i) {
+    snapshot.heads[1 + i] = ai_snakes_[i]->GetHeadCell();
+  }
+  game_state_->PublishSnapshot();
+}
+
+void Game::AdoptWorkerPath() {
+  if (!pathfinding_thread_) {
+    return;
+  }
+
+  const PathResult *result = pathfinding_thread_->PollResult();
+  // Paths planned for a previous round or an eaten food item are useless; a
+  // fresh request was already made when the board changed. AdoptPath drops
+  // any path that does not pass through the snake's head, which covers AI
+  // snakes reordered by a removal since the snapshot.
+  if (result && result->tick >= round_start_tick_ &&
+      result->target.x == food.x && result->target.y == food.y) {
+    for (std::size_t i = 0; i < ai_snakes_.size() && i < result->paths.size(); ++i) {
+      ai_snakes_[i]->AdoptPath(result->paths[i]);
+    }
+  }
+}
+
+std::shared_ptr<AISnake> Game::MakeAISnake(int x, int y) {
+  auto snake = std::make_shared<AISnake>(grid_width_, grid_height_, engine(), x, y);
+  snake->SetTicksPerSecond(config_.ticks_per_second);
+  snake->SetPlanner(config_.ai_planner);
+  if (config_.ai_pathfinder != PathfinderEngine::kAStar) {
+    snake->SetPathfinder(config_.ai_pathfinder);
+  }
+  snake->SetBoard(&blocked_);
+  snake->SetDistanceField(distance_field_.get());
+  snake->SetMctsPlanner(mcts_.get(), player_snake_.get());
+  if (space_search_) {
+    snake->SetSpaceCheck(&free_cells_, space_search_.get());
+  }
+  snake->SetExternalPlanning(pathfinding_thread_ != nullptr);
+  return snake;
+}
+
+// Creates the player and config_.ai_snakes AI snakes on an empty board. On a
+// board too small for all of them, spawning stops while one cell is still
+// free for the food.
+void Game::SpawnSnakes() {
+  std::size_t cells = static_cast<std::size_t>(grid_width_) * grid_height_;
+  owner_.assign(cells, 0);
+  blocked_.assign(cells, 0);
+  free_cells_.Fill();
+  free_set_.Fill();
+  pending_hits_.clear();
+
+  player_snake_ = std::make_shared<PlayerSnake>(grid_width_, grid_height_);
+  player_snake_->SetTicksPerSecond(config_.ticks_per_second);
+  ClaimCells(*player_snake_, kPlayerOwner);
+  player_snake_->ClearChangedCells();
+
+  ai_snakes_.clear();
+  for (int i = 0; i < config_.ai_snakes; ++i) {
+    int x = grid_width_ / 4;
+    int y = grid_height_ / 4;
+    if (i > 0) {
+      if (free_set_.Size() < 2) break;
+      int cell = free_set_.Pick(engine);
+      x = grid_.X(cell);
+      y = grid_.Y(cell);
+    }
+    ai_snakes_.push_back(MakeAISnake(x, y));
+    ClaimCells(*ai_snakes_.back(), kFirstAIOwner + i);
+    ai_snakes_.back()->ClearChangedCells();
+  }
+  board_changes_.clear();
+}
+
+void Game::RemoveAISnake(std::size_t index) {
+  std::uint16_t owner = kFirstAIOwner + index;
+  const AISnake &snake = *ai_snakes_[index];
+  for (const SDL_Point &point : snake.GetBody()) {
+    int cell = grid_.Index(point.x, point.y);
+    if (owner_[cell] == owner) SetOwner(cell, 0);
+  }
+  SDL_Point head_cell = snake.GetHeadCell();
+  int head = grid_.Index(head_cell.x, head_cell.y);
+  if (owner_[head] == owner) SetOwner(head, 0);
+
+  // Move the last snake into the gap and relabel the cells it owns.
+  std::size_t last = ai_snakes_.size() - 1;
+  if (index != last) {
+    std::uint16_t last_owner = kFirstAIOwner + last;
+    const AISnake &moved = *ai_snakes_[last];
+    for (const SDL_Point &point : moved.GetBody()) {
+      int cell = grid_.Index(point.x, point.y);
+      if (owner_[cell] == last_owner) owner_[cell] = owner;
+    }
+    SDL_Point moved_cell = moved.GetHeadCell();
+    int moved_head = grid_.Index(moved_cell.x, moved_cell.y);
+    if (owner_[moved_head] == last_owner) owner_[moved_head] = owner;
+    ai_snakes_[index] = std::move(ai_snakes_[last]);
+  }
+  ai_snakes_.pop_back();
 }
 
 int Game::GetPlayerScore() const { return player_score_; }
 int Game::GetAIScore() const { return ai_score_; }
 int Game::GetPlayerSize() const { return player_snake_->GetSize(); }
-int Game::GetAISize() const { return ai_snake_->GetSize(); }
 
-bool Game::CheckSnakeCollision(const SnakeBase* snake1, const SnakeBase* snake2) const {
-  if (!snake1 || !snake2) return false;
-  
-  int snake1_x = static_cast<int>(snake1->GetHeadX());
-  int snake1_y = static_cast<int>(snake1->GetHeadY());
-  
-  return snake2->SnakeCell(snake1_x, snake1_y);
+int Game::GetAISize() const {
+  int size = 0;
+  for (const auto &ai_snake : ai_snakes_) {
+    size = std::max(size, ai_snake->GetSize());
+  }
+  return size;
 }
 
+std::uint64_t Game::StateHash() const {
+  std::uint64_t hash = kStateHashSeed;
+  hash = HashValue(hash, tick_);
+  hash = HashValue(hash, food.x);
+  hash = HashValue(hash, food.y);
+  hash = HashValue(hash, player_score_);
+  hash = HashValue(hash, ai_score_);
+  hash = HashValue(hash, rounds_played_);
+  hash = player_snake_->StateHash(hash);
+  for (const auto &ai_snake : ai_snakes_) {
+    hash = ai_snake->StateHash(hash);
+  }
+  return hash;
+}
+
+// Resolves this tick's head-on-body hits in one pass over the owner grid.
+// Touching the player either way ends the round; an AI that ran into another
+// AI is taken off the board.
 void Game::HandleCollisions() {
-  // Check if player snake collided with AI snake
-  if (CheckSnakeCollision(player_snake_.get(), ai_snake_.get())) {
-    ResetGame();
-    return;
+  ScopedPhaseTimer timer(profiler_, FrameProfiler::Phase::kCollisions);
+  removed_ai_.clear();
+  bool round_over = false;
+  for (const PendingHit &hit : pending_hits_) {
+    std::uint16_t other = owner_[hit.cell];
+    if (other == 0) {
+      // The owner's tail left the cell later in the tick.
+      SetOwner(hit.cell, hit.owner);
+      continue;
+    }
+    if (hit.owner == kPlayerOwner || other == kPlayerOwner) {
+      round_over = true;
+      break;
+    }
+    removed_ai_.push_back(hit.owner - kFirstAIOwner);
   }
-  
-  // Check if AI snake collided with player snake
-  if (CheckSnakeCollision(ai_snake_.get(), player_snake_.get())) {
+  pending_hits_.clear();
+  if (round_over) {
     ResetGame();
     return;
   }
+
+  // Highest index first, so no swap-remove moves a snake still to be removed.
+  std::sort(removed_ai_.rbegin(), removed_ai_.rend());
+  for (std::size_t index : removed_ai_) {
+    RemoveAISnake(index);
+  }
 }
 
 void Game::ResetGame() {
+  rounds_played_++;
+  last_round_.player_score = player_score_;
+  last_round_.ai_score = ai_score_;
+  last_round_.player_size = player_snake_->GetSize();
+  last_round_.ai_size = GetAISize();
+  last_round_.ticks = tick_ - round_start_tick_;
+  last_round_.board_full = board_full_;
+  round_start_tick_ = tick_;
+  board_full_ = false;
+
   // Print final scores before reset
-  std::cout << "=== GAME OVER ===\n";
-  std::cout << "Final Scores - Player: " << player_score_ << " | AI: " << ai_score_ << "\n";
-  std::cout << "Snake Sizes - Player: " << player_snake_->GetSize() << " | AI: " << ai_snake_->GetSize() << "\n";
-  
-  if (player_score_ > ai_score_) {
-    std::cout << "Player wins this round!\n";
-  } else if (ai_score_ > player_score_) {
-    std::cout << "AI wins this round!\n";
-  } else {
-    std::cout << "It's a tie!\n";
+  if (config_.verbose) {
+    std::cout << "=== GAME OVER ===\n";
+    if (last_round_.board_full) {
+      std::cout << "The board is full!\n";
+    }
+    std::cout << "Final Scores - Player: " << player_score_ << " | AI: " << ai_score_ << "\n";
+    std::cout << "Snake Sizes - Player: " << player_snake_->GetSize() << " | AI: " << GetAISize() << "\n";
+
+    if (player_score_ > ai_score_) {
+      std::cout << "Player wins this round!\n";
+    } else if (ai_score_ > player_score_) {
+      std::cout << "AI wins this round!\n";
+    } else {
+      std::cout << "It's a tie!\n";
+    }
+
+    std::cout << "Restarting game...\n\n";
   }
   
-  std::cout << "Restarting game...\n\n";
-  
   // Reset scores
   player_score_ = 0;
   ai_score_ = 0;
   
   // Reset snakes
-  player_snake_ = std::make_shared<PlayerSnake>(grid_width_, grid_height_);
-  ai_snake_ = std::make_shared<AISnake>(grid_width_, grid_height_);
-  
-  // Update game state
-  game_state_->UpdatePlayerSnake(player_snake_);
-  game_state_->UpdateAISnake(ai_snake_);
+  SpawnSnakes();
   
-  // Place new food
+  // Place new food, which also asks the pathfinding thread for a new path
   PlaceFood();
-  
-  // Notify pathfinding thread
-  pathfinding_thread_->NotifyStateChanged();
 }
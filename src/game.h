@@ -1,49 +1,184 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <cstdint>
+#include <optional>
 #include <random>
 #include <memory>
-#include "SDL.h"
-#include "controller.h"
-#include "renderer.h"
+#include "sdl_types.h"
+#include "input_policy.h"
 #include "player_snake.h"
 #include "ai_snake.h"
 #include "game_state.h"
 #include "pathfinding_thread.h"
+#include "frame_profiler.h"
+#include "bit_grid.h"
+#include "free_cell_set.h"
+#include "grid.h"
+
+class Renderer;
+
+struct GameConfig {
+  // Snake speeds are per tick at this rate.
+  static constexpr int kBaseTicksPerSecond = SnakeBase::kBaseTicksPerSecond;
+  // Board side limits. Cell indices are ints and every per-cell array is
+  // sized for the whole board, so sides stop well short of int overflow.
+  static constexpr std::size_t kMinGridSize = 4;
+  static constexpr std::size_t kMaxGridSize = 8192;
+
+  std::size_t grid_width{32};
+  std::size_t grid_height{32};
+  // Hand food and obstacle updates to the AI through the background
+  // PathfindingThread. When false, Game updates the AI inline, which is what
+  // headless runs want.
+  bool async_pathfinding{true};
+  // Print the round summary to stdout whenever a round ends.
+  bool verbose{true};
+  // Seed for food placement and the AI snakes. Unset draws one from
+  // std::random_device. A seeded game without async_pathfinding is fully
+  // deterministic: the same per-tick input always yields the same state.
+  std::optional<std::uint32_t> seed;
+  // Let AI snakes refuse steps into pockets too small for their body,
+  // checked with bit-parallel flood fills over GetFreeCells().
+  bool ai_avoid_traps{false};
+  // Number of AI snakes. The first spawns at the usual quarter-board spot,
+  // the rest on random free cells.
+  int ai_snakes{1};
+  // Path planner for the AI. Planners other than kAStar always run inline,
+  // even when async_pathfinding is set, since each update only touches a few
+  // cells.
+  AIPlanner ai_planner{AIPlanner::kAStar};
+  // Search engine for the kAStar planner, inline or on the pathfinding
+  // thread. Engines can return different paths of the same length.
+  PathfinderEngine ai_pathfinder{PathfinderEngine::kAStar};
+  // Thread count and per-decision budget of the search when ai_planner is
+  // kMcts. One planner serves every AI snake, one decision at a time.
+  MctsPlanner::Options mcts;
+  // Simulation rate. Run() steps the game at this fixed rate whatever the
+  // frame rate, and snakes move proportionally less per tick above
+  // kBaseTicksPerSecond, so the game plays at the same speed.
+  int ticks_per_second{kBaseTicksPerSecond};
+};
+
+// Outcome of one round, captured right before the board is reset.
+struct RoundResult {
+  int player_score{0};
+  // Food eaten by all AI snakes together.
+  int ai_score{0};
+  int player_size{0};
+  // Length of the longest AI snake still on the board.
+  int ai_size{0};
+  std::uint64_t ticks{0};
+  // The snakes filled every cell, leaving nowhere to put the next food.
+  bool board_full{false};
+};
 
 class Game {
  public:
+  static constexpr std::uint16_t kPlayerOwner = 1;
+  static constexpr std::uint16_t kFirstAIOwner = 2;
+
   Game(std::size_t grid_width, std::size_t grid_height);
+  explicit Game(const GameConfig &config);
   ~Game();
-  void Run(Controller const &controller, Renderer &renderer,
-           std::size_t target_frame_duration);
+  // Runs the windowed game until the input asks to quit: fixed-rate ticks
+  // from an accumulator of real time, and one frame per display refresh
+  // drawn between the last two ticks. Defined in game_loop.cpp, which only
+  // the SDL build compiles.
+  void Run(InputPolicy &input, Renderer &renderer);
+  // Advances the game by one tick. Run() calls this at the configured tick
+  // rate; headless drivers such as Simulation call it directly.
+  void Update();
   int GetPlayerScore() const;
   int GetAIScore() const;
   int GetPlayerSize() const;
   int GetAISize() const;
+  PlayerSnake &GetPlayerSnake() { return *player_snake_; }
+  const PlayerSnake &GetPlayerSnake() const { return *player_snake_; }
+  const std::vector<std::shared_ptr<AISnake>> &GetAISnakes() const { return ai_snakes_; }
+  // Which snake owns each cell (see owner_), indexed by y * grid_width + x.
+  const std::vector<std::uint16_t> &GetOwners() const { return owner_; }
+  // Non-zero where any snake segment is, indexed by y * grid_width + x.
+  const std::vector<std::uint8_t> &GetBlockedCells() const { return blocked_; }
+  // The same board as one bit per cell, set where the cell is free.
+  const BitGrid &GetFreeCells() const { return free_cells_; }
+  SDL_Point GetFood() const { return food; }
+  std::uint64_t GetTick() const { return tick_; }
+  int GetRoundsPlayed() const { return rounds_played_; }
+  const RoundResult &GetLastRound() const { return last_round_; }
+  // The AI's search, or nullptr unless ai_planner is kMcts.
+  const MctsPlanner *GetMctsPlanner() const { return mcts_.get(); }
+  // Attaches a profiler that receives per-phase timings from Run() and
+  // Update(). Pass nullptr to stop profiling.
+  void SetProfiler(FrameProfiler *profiler) { profiler_ = profiler; }
+  // Hash of the board, both snakes, scores and tick, for replay verification.
+  std::uint64_t StateHash() const;
 
  private:
+  GameConfig config_;
   std::shared_ptr<PlayerSnake> player_snake_;
-  std::shared_ptr<AISnake> ai_snake_;
+  // Live AI snakes. One that runs into another AI is removed with a
+  // swap-remove, so the order (and their owner ids) can change.
+  std::vector<std::shared_ptr<AISnake>> ai_snakes_;
   std::shared_ptr<GameState> game_state_;
   std::unique_ptr<PathfindingThread> pathfinding_thread_;
+  // Distance to the food shared by all AI snakes; only with kDistanceField.
+  std::unique_ptr<DistanceField> distance_field_;
+  // Lookahead search shared by all AI snakes; only with kMcts.
+  std::unique_ptr<MctsPlanner> mcts_;
   SDL_Point food;
 
-  std::random_device dev;
   std::mt19937 engine;
-  std::uniform_int_distribution<int> random_w;
-  std::uniform_int_distribution<int> random_h;
 
   int grid_width_;
   int grid_height_;
+  // Index arithmetic for the owner and blocked grids below.
+  RuntimeGrid grid_;
   int player_score_{0};
   int ai_score_{0};
+  std::uint64_t tick_{0};
+  int rounds_played_{0};
+  std::uint64_t round_start_tick_{0};
+  RoundResult last_round_;
+  // Which snake owns each cell: 0 for none, kPlayerOwner for the player and
+  // kFirstAIOwner + i for ai_snakes_[i]. Kept current as each snake moves;
+  // blocked_ mirrors it as a 0/1 grid for the planners.
+  std::vector<std::uint16_t> owner_;
+  std::vector<std::uint8_t> blocked_;
+  BitGrid free_cells_;
+  // The same free cells as a set, for picking a random one in O(1).
+  FreeCellSet free_set_;
+  // Flood-fill scratch shared by the AI snakes' trap checks.
+  std::unique_ptr<BitBoardSearch> space_search_;
+  // A head that entered a cell owned by another snake. Resolved once every
+  // snake has moved, since that snake's tail may still leave the cell.
+  struct PendingHit {
+    std::uint16_t owner;
+    int cell;
+  };
+  std::vector<PendingHit> pending_hits_;
+  // Cells whose blocked_ value changed this tick, for the incremental planners.
+  std::vector<int> board_changes_;
+  std::vector<std::size_t> removed_ai_;
+  FrameProfiler *profiler_{nullptr};
+  bool replan_pending_{false};
+  // Set when PlaceFood found no free cell; ends the round.
+  bool board_full_{false};
 
-  void PlaceFood();
-  void Update();
-  bool CheckSnakeCollision(const SnakeBase* snake1, const SnakeBase* snake2) const;
+  bool PlaceFood();
+  void AdoptWorkerPath();
+  void PublishSnapshot();
+  void FinishTick();
   void HandleCollisions();
   void ResetGame();
+  void SpawnSnakes();
+  std::shared_ptr<AISnake> MakeAISnake(int x, int y);
+  void ClaimCells(const SnakeBase &snake, std::uint16_t owner);
+  void ApplyMoves(SnakeBase &snake, std::uint16_t owner);
+  void SetOwner(int cell, std::uint16_t owner);
+  void RemoveAISnake(std::size_t index);
+  void ResetDistanceField();
+  void SyncBoardChanges();
 };
 
 #endif
@@ -0,0 +1,117 @@
+#include "game.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "SDL.h"
+#include "renderer.h"
+
+// The windowed game loop, kept apart from the rest of Game so the headless
+// simulator builds without SDL or the Renderer.
+
+namespace {
+
+// Longest stretch of real time one frame will simulate.
+constexpr std::chrono::milliseconds kMaxCatchUp{250};
+
+// With vsync, extra time the loop leaves before the next refresh on top of
+// what the last frames took from waking up to presenting.
+constexpr std::chrono::milliseconds kVsyncMargin{2};
+
+// Sleeps until |deadline| in slices of at most a millisecond, pumping events
+// between them so key presses are stamped when they happen. The last half
+// millisecond is spun, since a sleep can overshoot by about that much.
+void WaitUntil(std::chrono::steady_clock::time_point deadline) {
+  constexpr std::chrono::microseconds kSpin{500};
+  constexpr std::chrono::microseconds kSlice{1000};
+  while (true) {
+    SDL_PumpEvents();
+    auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining <= remaining.zero()) {
+      return;
+    }
+    if (remaining > kSpin) {
+      std::this_thread::sleep_for(
+          std::min<std::chrono::steady_clock::duration>(remaining - kSpin, kSlice));
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace
+
+void Game::Run(InputPolicy &input, Renderer &renderer) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::duration tick_duration = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / config_.ticks_per_second));
+  const Clock::duration frame_duration = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / renderer.GetRefreshRate()));
+
+  Clock::time_point previous = Clock::now();
+  Clock::time_point next_frame = previous;
+  Clock::time_point title_timestamp = previous;
+  Clock::duration accumulator{0};
+  // With vsync: how long before the refresh the loop must wake to have the
+  // frame drawn in time, i.e. the sleep's overshoot plus simulating and
+  // drawing. Follows spikes at once and drops back slowly.
+  Clock::duration vsync_lead{0};
+  int frame_count = 0;
+  bool running = true;
+
+  while (running && game_state_->game_running) {
+    Clock::time_point frame_start = Clock::now();
+    // A long stall (a debugger, a dragged window) is not caught up on tick
+    // by tick; the game just loses that time.
+    accumulator += std::min<Clock::duration>(frame_start - previous, kMaxCatchUp);
+    previous = frame_start;
+
+    // Input, Update, Render - the main game loop. The game advances in
+    // fixed ticks for the real time that passed, however long frames take,
+    // and the frame shows the board part way into the next tick.
+    bool presented;
+    {
+      ScopedPhaseTimer frame_timer(profiler_, FrameProfiler::Phase::kFrame);
+      while (running && accumulator >= tick_duration) {
+        {
+          ScopedPhaseTimer timer(profiler_, FrameProfiler::Phase::kInput);
+          running = input.Apply(*this, *player_snake_);
+        }
+        {
+          ScopedPhaseTimer timer(profiler_, FrameProfiler::Phase::kUpdate);
+          Update();
+        }
+        accumulator -= tick_duration;
+      }
+      float alpha = std::chrono::duration<float>(accumulator) / tick_duration;
+      presented = renderer.Render(*player_snake_, ai_snakes_, food, owner_, alpha);
+    }
+
+    // After every second, update the window title.
+    frame_count++;
+    Clock::time_point frame_end = Clock::now();
+    if (frame_end - title_timestamp >= std::chrono::seconds(1)) {
+      renderer.UpdateWindowTitle(player_score_, ai_score_, frame_count);
+      frame_count = 0;
+      title_timestamp = frame_end;
+    }
+
+    // With vsync, presenting returned at a refresh, so the next one is a
+    // frame later. Rather than block in SDL_RenderPresent, where no events
+    // are pumped and presses would only be stamped when the next tick polls
+    // them, wait for it here and wake just in time to simulate and draw.
+    // Otherwise, or when the frame was skipped, wait for the next refresh
+    // deadline.
+    if (presented && renderer.HasVsync()) {
+      Clock::duration lead = frame_end - renderer.GetLastPresentTime() - next_frame;
+      vsync_lead = std::max(lead, vsync_lead - vsync_lead / 16);
+      next_frame = frame_end + frame_duration -
+                   std::min<Clock::duration>(vsync_lead + kVsyncMargin, frame_duration);
+    } else {
+      next_frame += frame_duration;
+      if (next_frame < frame_end) {
+        next_frame = frame_end;
+      }
+    }
+    WaitUntil(next_frame);
+  }
+}
@@ -1,39 +1,51 @@
 #ifndef GAME_STATE_H
 #define GAME_STATE_H
 
-#include <mutex>
 #include <atomic>
-#include <memory>
-#include "SDL.h"
-#include "snake_base.h"
-#include "player_snake.h"
-#include "ai_snake.h"
+#include <cstdint>
+#include <vector>
+#include "sdl_types.h"
+#include "triple_buffer.h"
 
+// Immutable picture of the board at the end of one tick. It holds copies
+// only, never pointers into live snakes, so a reader sees exactly one tick.
+struct BoardSnapshot {
+  std::uint64_t tick{0};
+  SDL_Point food{0, 0};
+  // heads[0] is the player snake, heads[1 + i] AI snake i.
+  std::vector<SDL_Point> heads;
+  // Non-zero where any snake segment is, indexed by y * grid_width + x.
+  std::vector<std::uint8_t> blocked;
+};
+
+// Shared state between the main loop and the pathfinding thread. The main
+// thread fills a BoardSnapshot in place and publishes it every tick; the
+// (single) reader picks up the newest one. Neither side ever takes a lock or
+// waits for the other.
 class GameState {
  public:
   GameState(int grid_width, int grid_height);
-  
-  void UpdateFood(const SDL_Point& food_position);
-  void UpdatePlayerSnake(std::shared_ptr<PlayerSnake> player_snake);
-  void UpdateAISnake(std::shared_ptr<AISnake> ai_snake);
-  
-  SDL_Point GetFood() const;
-  std::shared_ptr<PlayerSnake> GetPlayerSnake() const;
-  std::shared_ptr<AISnake> GetAISnake() const;
-  
-  std::vector<const SnakeBase*> GetObstacles() const;
-  
+
+  // Main thread: the snapshot to fill for this tick, then publish it.
+  BoardSnapshot& BeginSnapshot() { return snapshots_.WriteBuffer(); }
+  void PublishSnapshot() { snapshots_.Publish(); }
+
+  // Reader thread: switches to the newest published snapshot (if any newer
+  // one exists) and returns it. The reference stays valid and unchanged
+  // until the next call.
+  const BoardSnapshot& LatestSnapshot();
+
+  int GetGridWidth() const { return grid_width_; }
+  int GetGridHeight() const { return grid_height_; }
+
   std::atomic<bool> game_running{true};
   std::atomic<int> player_score{0};
   std::atomic<int> ai_score{0};
-  
+
  private:
-  mutable std::mutex state_mutex_;
-  SDL_Point food_position_;
-  std::shared_ptr<PlayerSnake> player_snake_;
-  std::shared_ptr<AISnake> ai_snake_;
+  TripleBuffer<BoardSnapshot> snapshots_;
   int grid_width_;
   int grid_height_;
 };
 
-#endif
\ No newline at end of file
+#endif
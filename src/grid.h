@@ -0,0 +1,127 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <algorithm>
+#include <cstdlib>
+
+// Cell arithmetic for the wrap-around board, with cells indexed
+// y * width + x and directions in SnakeBase::Direction order (up, down,
+// left, right).
+//
+// Grid<W, H> fixes the size at compile time. Its neighbour offsets are a
+// constexpr table, and when both sides are powers of two, x and y are a
+// mask and a shift and wrapping is a mask, so a neighbour step is a couple
+// of integer instructions with no division or branch. RuntimeGrid offers
+// the same interface for any size. DispatchGrid() hands a search the
+// specialisation for the board it runs on.
+template <int W, int H>
+class Grid {
+  static_assert(W > 0 && H > 0, "Grid dimensions must be positive");
+
+ public:
+  constexpr int Width() const { return W; }
+  constexpr int Height() const { return H; }
+  constexpr int Cells() const { return kCells; }
+  constexpr int Index(int x, int y) const { return y * W + x; }
+  constexpr int X(int cell) const { return kMaskWrap ? cell & (W - 1) : cell % W; }
+  constexpr int Y(int cell) const { return kMaskWrap ? cell >> kShift : cell / W; }
+
+  // The cell next to |cell| in |direction|, wrapping around the edges.
+  constexpr int Neighbour(int cell, int direction) const {
+    int next = cell + kOffsets[direction];
+    if constexpr (kMaskWrap) {
+      if (direction < 2) return next & (kCells - 1);
+      return (cell & ~(W - 1)) | (next & (W - 1));
+    } else {
+      if (direction < 2) {
+        if (next < 0) return next + kCells;
+        if (next >= kCells) return next - kCells;
+        return next;
+      }
+      int x = X(cell) + kOffsets[direction];
+      if (x < 0) return next + W;
+      if (x >= W) return next - W;
+      return next;
+    }
+  }
+
+  // Manhattan distance between two cells, the short way around each axis.
+  constexpr int Distance(int a, int b) const {
+    int dx = std::abs(X(a) - X(b));
+    int dy = std::abs(Y(a) - Y(b));
+    return std::min(dx, W - dx) + std::min(dy, H - dy);
+  }
+
+ private:
+  static constexpr bool IsPowerOfTwo(int n) { return (n & (n - 1)) == 0; }
+  static constexpr int Log2(int n) { return n > 1 ? 1 + Log2(n / 2) : 0; }
+
+  static constexpr int kCells = W * H;
+  static constexpr bool kMaskWrap = IsPowerOfTwo(W) && IsPowerOfTwo(H);
+  static constexpr int kShift = Log2(W);
+  static constexpr int kOffsets[4] = {-W, W, -1, 1};
+};
+
+// Grid for sizes without a specialisation. A power-of-two width still gets
+// a mask and a shift for x and y, chosen at runtime; wrapping compares
+// instead of dividing.
+class RuntimeGrid {
+ public:
+  RuntimeGrid(int width, int height)
+      : width_(width),
+        height_(height),
+        cells_(width * height),
+        shift_((width & (width - 1)) == 0 ? Log2(width) : -1) {}
+
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+  int Cells() const { return cells_; }
+  int Index(int x, int y) const { return y * width_ + x; }
+  int X(int cell) const { return shift_ >= 0 ? cell & (width_ - 1) : cell % width_; }
+  int Y(int cell) const { return shift_ >= 0 ? cell >> shift_ : cell / width_; }
+
+  int Neighbour(int cell, int direction) const {
+    switch (direction) {
+      case 0: return cell >= width_ ? cell - width_ : cell - width_ + cells_;
+      case 1: return cell + width_ < cells_ ? cell + width_ : cell + width_ - cells_;
+      case 2: return X(cell) != 0 ? cell - 1 : cell + width_ - 1;
+      default: return X(cell) != width_ - 1 ? cell + 1 : cell - width_ + 1;
+    }
+  }
+
+  int Distance(int a, int b) const {
+    int dx = std::abs(X(a) - X(b));
+    int dy = std::abs(Y(a) - Y(b));
+    return std::min(dx, width_ - dx) + std::min(dy, height_ - dy);
+  }
+
+ private:
+  static int Log2(int n) { return n > 1 ? 1 + Log2(n / 2) : 0; }
+
+  int width_;
+  int height_;
+  int cells_;
+  // log2(width_) when the width is a power of two, else -1.
+  int shift_;
+};
+
+// Calls |f| with a Grid<N, N> for the square power-of-two boards from
+// 16x16 to 1024x1024, and with a RuntimeGrid for any other size. Every
+// instantiation of |f| must return the same type.
+template <typename F>
+auto DispatchGrid(int width, int height, F &&f) {
+  if (width == height) {
+    switch (width) {
+      case 16: return f(Grid<16, 16>{});
+      case 32: return f(Grid<32, 32>{});
+      case 64: return f(Grid<64, 64>{});
+      case 128: return f(Grid<128, 128>{});
+      case 256: return f(Grid<256, 256>{});
+      case 512: return f(Grid<512, 512>{});
+      case 1024: return f(Grid<1024, 1024>{});
+    }
+  }
+  return f(RuntimeGrid(width, height));
+}
+
+#endif
@@ -0,0 +1,310 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include "game.h"
+#include "input_policy.h"
+#include "match_runner.h"
+#include "replay.h"
+#include "simulation.h"
+#include "software_renderer.h"
+#include "video_writer.h"
+
+namespace {
+
+// Videos are laid out like the SnakeGame window and hold one frame per tick,
+// so they play at the game's tick rate.
+constexpr int kVideoWidth = 640;
+constexpr int kVideoHeight = 640;
+
+void PrintUsage() {
+  std::cout << "Usage: SnakeSim [--ticks N] [--grid N] [--policy bot|idle]\n"
+            << "                [--planner astar|incremental|field|mcts] [--pathfinder astar|bfs|bidir|jps]\n"
+            << "                [--ai-snakes N] [--avoid-traps] [--seed N] [--record FILE]\n"
+            << "                [--video FILE.y4m|FILE.ppm|-]\n"
+            << "       SnakeSim --matches N [--threads N] [--max-ticks N] [--grid N] [--seed N]\n"
+            << "                [--planner astar|incremental|field|mcts] [--pathfinder astar|bfs|bidir|jps]\n"
+            << "                [--ai-snakes N] [--avoid-traps]\n"
+            << "       MCTS options: [--mcts-budget US] [--mcts-threads N] [--mcts-playouts N]\n"
+            << "       SnakeSim --replay FILE [--video FILE.y4m|FILE.ppm|-]\n";
+}
+
+// Y4M at |fps| unless |path| ends in .ppm; "-" streams Y4M to stdout.
+std::unique_ptr<VideoWriter> OpenVideo(const std::string &path, int fps) {
+  bool ppm = path.size() >= 4 && path.compare(path.size() - 4, 4, ".ppm") == 0;
+  auto writer = std::make_unique<VideoWriter>(
+      kVideoWidth, kVideoHeight, fps,
+      ppm ? VideoWriter::Format::kPPM : VideoWriter::Format::kY4M);
+  if (!writer->Open(path)) {
+    return nullptr;
+  }
+  return writer;
+}
+
+// Finishes the video and reports on stderr, which stays clean of frame data
+// when the video goes to stdout.
+bool CloseVideo(VideoWriter &writer, const std::string &path) {
+  bool ok = writer.Close();
+  std::chrono::duration<double> stalled = writer.GetStallTime();
+  std::cerr << "Wrote " << writer.GetFramesWritten() << " frames to " << path << " ("
+            << stalled.count() << " s waiting on the writer)\n";
+  return ok;
+}
+
+int Replay(const std::string &path, const std::string &video_path) {
+  ReplayLog log;
+  if (!log.Load(path)) {
+    return 1;
+  }
+
+  GameConfig config;
+  config.grid_width = log.grid_width;
+  config.grid_height = log.grid_height;
+  config.async_pathfinding = false;
+  config.verbose = false;
+  config.seed = log.seed;
+  config.ai_snakes = log.ai_snakes;
+  config.ticks_per_second = log.ticks_per_second;
+  Game game(config);
+  ReplayInput input(log);
+  Simulation simulation(game, input);
+
+  std::unique_ptr<VideoWriter> video;
+  std::unique_ptr<SoftwareRenderer> renderer;
+  if (!video_path.empty()) {
+    video = OpenVideo(video_path, config.ticks_per_second);
+    if (!video) {
+      return 1;
+    }
+    renderer = std::make_unique<SoftwareRenderer>(*video, config.grid_width, config.grid_height);
+    simulation.SetRenderer(renderer.get());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::uint64_t simulated = simulation.Run(log.final_tick);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  if (video && !CloseVideo(*video, video_path)) {
+    return 1;
+  }
+
+  // Keep stdout for frame data when the video is streamed there.
+  std::ostream &out = video_path == "-" ? std::cerr : std::cout;
+  out << "Replayed " << simulated << " ticks (" << log.events.size()
+      << " direction changes) in " << elapsed.count() << " s\n";
+  if (!input.Verify(game)) {
+    out << "Replay diverged at tick " << input.FirstMismatch().value_or(game.GetTick()) << "\n";
+    return 1;
+  }
+  out << "Final state hash matches: " << std::hex << log.final_hash << std::dec << "\n";
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::uint64_t ticks{1000000};
+  std::size_t grid_size{32};
+  std::string policy{"bot"};
+  std::optional<std::uint32_t> seed;
+  std::string record_path;
+  std::string replay_path;
+  std::string video_path;
+  AIPlanner planner{AIPlanner::kAStar};
+  PathfinderEngine pathfinder{PathfinderEngine::kAStar};
+  int ai_snakes{1};
+  bool avoid_traps = false;
+  MctsPlanner::Options mcts;
+  bool mcts_threads_set = false;
+  MatchRunnerConfig match_config;
+  bool run_matches = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+      grid_size = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+      policy = argv[++i];
+    } else if (std::strcmp(argv[i], "--planner") == 0 && i + 1 < argc) {
+      std::string name = argv[++i];
+      if (name == "astar") {
+        planner = AIPlanner::kAStar;
+      } else if (name == "incremental") {
+        planner = AIPlanner::kIncremental;
+      } else if (name == "field") {
+        planner = AIPlanner::kDistanceField;
+      } else if (name == "mcts") {
+        planner = AIPlanner::kMcts;
+      } else {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--pathfinder") == 0 && i + 1 < argc) {
+      if (!ParsePathfinder(argv[++i], pathfinder)) {
+        PrintUsage();
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--mcts-budget") == 0 && i + 1 < argc) {
+      mcts.budget = std::chrono::microseconds(std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "--mcts-threads") == 0 && i + 1 < argc) {
+      mcts.threads = std::atoi(argv[++i]);
+      mcts_threads_set = true;
+    } else if (std::strcmp(argv[i], "--mcts-playouts") == 0 && i + 1 < argc) {
+      mcts.playouts = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--ai-snakes") == 0 && i + 1 < argc) {
+      ai_snakes = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--avoid-traps") == 0) {
+      avoid_traps = true;
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      record_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replay_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--video") == 0 && i + 1 < argc) {
+      video_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+      match_config.matches = std::atoi(argv[++i]);
+      run_matches = true;
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      match_config.threads = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+      match_config.max_ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  if (!replay_path.empty()) {
+    return Replay(replay_path, video_path);
+  }
+
+  if (grid_size < GameConfig::kMinGridSize || grid_size > GameConfig::kMaxGridSize) {
+    std::cerr << "--grid must be between " << GameConfig::kMinGridSize << " and "
+              << GameConfig::kMaxGridSize << "\n";
+    return 1;
+  }
+  // Every snake needs a free cell to spawn on, with room left for food.
+  if (ai_snakes < 0 || static_cast<std::size_t>(ai_snakes) >= grid_size * grid_size / 2) {
+    std::cerr << "--ai-snakes must be between 0 and half the board\n";
+    return 1;
+  }
+
+  if (mcts.budget.count() < 1 || mcts.threads < 0 || mcts.playouts < 0) {
+    std::cerr << "--mcts-budget must be positive, --mcts-threads and --mcts-playouts not negative\n";
+    return 1;
+  }
+
+  if (run_matches) {
+    match_config.grid_width = grid_size;
+    match_config.grid_height = grid_size;
+    if (seed) match_config.seed = *seed;
+    match_config.ai_planner = planner;
+    match_config.ai_pathfinder = pathfinder;
+    match_config.ai_snakes = ai_snakes;
+    match_config.ai_avoid_traps = avoid_traps;
+    match_config.mcts = mcts;
+    if (!mcts_threads_set) {
+      // The matches already keep every core busy.
+      match_config.mcts.threads = 1;
+    }
+
+    MatchRunner runner(match_config);
+    auto start = std::chrono::steady_clock::now();
+    MatchTally tally = runner.Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    MatchRunner::PrintSummary(std::cout, tally);
+    std::cout << "Played " << tally.matches << " matches in " << elapsed.count() << " s ("
+              << static_cast<std::uint64_t>(tally.total_ticks / elapsed.count()) << " ticks/s)\n";
+    return 0;
+  }
+
+  GameConfig config;
+  config.grid_width = grid_size;
+  config.grid_height = grid_size;
+  config.async_pathfinding = false;
+  config.verbose = false;
+  if (!record_path.empty() && !seed) {
+    // A recording is only replayable if the seed is known.
+    seed = std::random_device{}();
+  }
+  config.seed = seed;
+  config.ai_planner = planner;
+  config.ai_pathfinder = pathfinder;
+  config.ai_snakes = ai_snakes;
+  config.ai_avoid_traps = avoid_traps;
+  config.mcts = mcts;
+  if (!record_path.empty() &&
+      (planner != AIPlanner::kAStar || pathfinder != PathfinderEngine::kAStar || avoid_traps)) {
+    // Replay logs do not store AI options and always re-simulate the default AI.
+    std::cerr << "--record only supports the default AI options\n";
+    return 1;
+  }
+  Game game(config);
+
+  std::unique_ptr<InputPolicy> input;
+  if (policy == "bot") {
+    input = std::make_unique<BotInput>(grid_size, grid_size);
+  } else if (policy == "idle") {
+    input = std::make_unique<ScriptedInput>(std::vector<ScriptedInput::Move>{});
+  } else {
+    PrintUsage();
+    return 1;
+  }
+
+  ReplayLog log;
+  std::unique_ptr<RecordingInput> recorder;
+  if (!record_path.empty()) {
+    log.seed = *seed;
+    log.grid_width = grid_size;
+    log.grid_height = grid_size;
+    log.ai_snakes = ai_snakes;
+    log.ticks_per_second = config.ticks_per_second;
+    recorder = std::make_unique<RecordingInput>(*input, log);
+  }
+
+  Simulation simulation(game, recorder ? *recorder : *input);
+  std::unique_ptr<VideoWriter> video;
+  std::unique_ptr<SoftwareRenderer> renderer;
+  if (!video_path.empty()) {
+    video = OpenVideo(video_path, config.ticks_per_second);
+    if (!video) {
+      return 1;
+    }
+    renderer = std::make_unique<SoftwareRenderer>(*video, grid_size, grid_size);
+    simulation.SetRenderer(renderer.get());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::uint64_t simulated = simulation.Run(ticks);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  if (video && !CloseVideo(*video, video_path)) {
+    return 1;
+  }
+
+  if (recorder) {
+    recorder->Finish(game);
+    if (!log.Save(record_path)) {
+      return 1;
+    }
+  }
+
+  std::ostream &out = video_path == "-" ? std::cerr : std::cout;
+  out << "Simulated " << simulated << " ticks in " << elapsed.count() << " s ("
+      << static_cast<std::uint64_t>(simulated / elapsed.count()) << " ticks/s)\n";
+  out << "Rounds played: " << game.GetRoundsPlayed() << "\n";
+  out << "Player Score: " << game.GetPlayerScore() << "\n";
+  out << "AI Score: " << game.GetAIScore() << "\n";
+  if (const MctsPlanner *search = game.GetMctsPlanner()) {
+    if (search->GetDecisions() > 0) {
+      out << "MCTS: " << search->GetDecisions() << " decisions, "
+          << search->GetPlayouts() / search->GetDecisions() << " playouts each on "
+          << search->GetThreads() << " threads\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "input_policy.h"
+#include "game.h"
+
+ScriptedInput::ScriptedInput(std::vector<Move> moves) : moves_(std::move(moves)) {}
+
+bool ScriptedInput::Apply(const Game &game, PlayerSnake &snake) {
+  while (next_move_ < moves_.size() && moves_[next_move_].tick <= game.GetTick()) {
+    SnakeBase::Direction direction = moves_[next_move_].direction;
+    snake.ChangeDirection(direction, SnakeBase::Opposite(direction));
+    next_move_++;
+  }
+  return true;
+}
+
+BotInput::BotInput(int grid_width, int grid_height)
+    : pathfinder_(grid_width, grid_height),
+      grid_width_(grid_width),
+      grid_height_(grid_height) {}
+
+bool BotInput::Apply(const Game &game, PlayerSnake &snake) {
+  SDL_Point cell = snake.GetHeadCell();
+  SDL_Point food = game.GetFood();
+
+  if (cell.x == last_cell_.x && cell.y == last_cell_.y &&
+      food.x == last_food_.x && food.y == last_food_.y) {
+    return true;
+  }
+  last_cell_ = cell;
+  last_food_ = food;
+
+  const std::vector<std::uint8_t> &blocked = game.GetBlockedCells();
+  pathfinder_.FindPath(cell, food, blocked, path_);
+
+  SnakeBase::Direction direction = ChooseDirection(snake, cell, blocked);
+  snake.ChangeDirection(direction, SnakeBase::Opposite(direction));
+  return true;
+}
+
+SnakeBase::Direction BotInput::ChooseDirection(const SnakeBase &snake, const SDL_Point &cell,
+                                               const std::vector<std::uint8_t> &blocked) const {
+  if (path_.size() >= 2) {
+    return DirectionTo(cell, path_[1]);
+  }
+
+  // No route to the food: keep going if the next cell is free, otherwise take
+  // any free turn.
+  static constexpr SnakeBase::Direction kDirections[] = {
+      SnakeBase::Direction::kUp, SnakeBase::Direction::kDown,
+      SnakeBase::Direction::kLeft, SnakeBase::Direction::kRight};
+  static constexpr int kOffsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+
+  SnakeBase::Direction fallback = snake.direction;
+  for (int i = 0; i < 4; ++i) {
+    if (kDirections[i] == SnakeBase::Opposite(snake.direction)) {
+      continue;
+    }
+    int nx = (cell.x + kOffsets[i][0] + grid_width_) % grid_width_;
+    int ny = (cell.y + kOffsets[i][1] + grid_height_) % grid_height_;
+    if (!blocked[ny * grid_width_ + nx]) {
+      if (kDirections[i] == snake.direction) {
+        return snake.direction;
+      }
+      fallback = kDirections[i];
+    }
+  }
+  return fallback;
+}
+
+SnakeBase::Direction BotInput::DirectionTo(const SDL_Point &from, const SDL_Point &to) const {
+  int dx = to.x - from.x;
+  int dy = to.y - from.y;
+
+  // Path steps are single cells, so a large delta means the step wrapped.
+  if (dx > 1) dx = -1;
+  if (dx < -1) dx = 1;
+  if (dy > 1) dy = -1;
+  if (dy < -1) dy = 1;
+
+  if (dx != 0) {
+    return (dx > 0) ? SnakeBase::Direction::kRight : SnakeBase::Direction::kLeft;
+  }
+  return (dy > 0) ? SnakeBase::Direction::kDown : SnakeBase::Direction::kUp;
+}
@@ -0,0 +1,60 @@
+#ifndef INPUT_POLICY_H
+#define INPUT_POLICY_H
+
+#include <cstdint>
+#include <vector>
+#include "sdl_types.h"
+#include "player_snake.h"
+#include "astar_pathfinder.h"
+
+class Game;
+
+// Source of player input. Game::Run and Simulation call Apply() once per tick,
+// right before Game::Update().
+class InputPolicy {
+ public:
+  virtual ~InputPolicy() = default;
+
+  // Steers |snake|. Returns false when the game should stop.
+  virtual bool Apply(const Game &game, PlayerSnake &snake) = 0;
+};
+
+// Replays a fixed list of direction changes, each applied at its tick.
+class ScriptedInput : public InputPolicy {
+ public:
+  struct Move {
+    std::uint64_t tick;
+    SnakeBase::Direction direction;
+  };
+
+  explicit ScriptedInput(std::vector<Move> moves);
+
+  bool Apply(const Game &game, PlayerSnake &snake) override;
+
+ private:
+  std::vector<Move> moves_;
+  std::size_t next_move_{0};
+};
+
+// Drives the player snake toward the food with A*, replanning whenever the
+// head enters a new cell or the food moves.
+class BotInput : public InputPolicy {
+ public:
+  BotInput(int grid_width, int grid_height);
+
+  bool Apply(const Game &game, PlayerSnake &snake) override;
+
+ private:
+  AStarPathfinder pathfinder_;
+  std::vector<SDL_Point> path_;
+  SDL_Point last_cell_{-1, -1};
+  SDL_Point last_food_{-1, -1};
+  int grid_width_;
+  int grid_height_;
+
+  SnakeBase::Direction ChooseDirection(const SnakeBase &snake, const SDL_Point &cell,
+                                       const std::vector<std::uint8_t> &blocked) const;
+  SnakeBase::Direction DirectionTo(const SDL_Point &from, const SDL_Point &to) const;
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "jump_point_pathfinder.h"
+#include <algorithm>
+#include <limits>
+#include "grid.h"
+
+namespace {
+
+// In SnakeBase::Direction order. A direction's opposite is its index with
+// the low bit flipped.
+constexpr int kUp = 0;
+constexpr int kDown = 1;
+constexpr int kLeft = 2;
+constexpr int kRight = 3;
+
+bool IsVertical(int direction) { return direction <= kDown; }
+
+}  // namespace
+
+JumpPointPathfinder::JumpPointPathfinder(int grid_width, int grid_height)
+    : grid_width_(grid_width),
+      grid_height_(grid_height),
+      cells_(static_cast<std::size_t>(grid_width) * grid_height) {}
+
+bool JumpPointPathfinder::FindPath(const SDL_Point& start, const SDL_Point& goal,
+                                   const std::vector<std::uint8_t>& blocked,
+                                   std::vector<SDL_Point>& path) {
+  path.clear();
+  BeginSearch();
+  blocked_ = &blocked;
+
+  int start_cell = start.y * grid_width_ + start.x;
+  goal_cell_ = goal.y * grid_width_ + goal.x;
+  return DispatchGrid(grid_width_, grid_height_, [&](const auto& grid) {
+    return Search(grid, start_cell, path);
+  });
+}
+
+template <typename GridT>
+bool JumpPointPathfinder::Search(const GridT& grid, int start_cell, std::vector<SDL_Point>& path) {
+  CellRecord& start_record = cells_[start_cell];
+  start_record = CellRecord{};
+  start_record.generation = generation_;
+  start_record.arrived = kFromStart;
+  open_heap_.push_back({grid.Distance(start_cell, goal_cell_), 0, start_cell});
+
+  while (!open_heap_.empty()) {
+    std::pop_heap(open_heap_.begin(), open_heap_.end(), HeapOrder);
+    OpenEntry current = open_heap_.back();
+    open_heap_.pop_back();
+
+    CellRecord& record = cells_[current.cell];
+    std::uint8_t pending = record.arrived & ~record.expanded;
+    if (current.g_cost != record.g_cost || pending == 0) {
+      continue;
+    }
+    record.expanded |= pending;
+    expanded_++;
+
+    if (current.cell == goal_cell_) {
+      ReconstructPath(grid, start_cell, path);
+      return true;
+    }
+
+    std::uint8_t successors = (pending & kFromStart) ? 0xF : 0;
+    for (int direction = 0; direction < 4; ++direction) {
+      if (pending & (1 << direction)) {
+        successors |= Successors(grid, current.cell, direction);
+      }
+    }
+    for (int direction = 0; direction < 4; ++direction) {
+      if (!(successors & (1 << direction))) continue;
+      int steps = 0;
+      int jump_point = Jump(grid, current.cell, direction, steps);
+      if (jump_point >= 0) {
+        Relax(grid, current.cell, jump_point, current.g_cost + steps, direction);
+      }
+    }
+  }
+  return false;
+}
+
+void JumpPointPathfinder::BeginSearch() {
+  open_heap_.clear();
+  expanded_ = 0;
+  if (++generation_ == 0) {
+    for (auto& record : cells_) {
+      record.generation = 0;
+    }
+    generation_ = 1;
+  }
+}
+
+// Same order as AStarPathfinder: lowest f, then the deeper node.
+bool JumpPointPathfinder::HeapOrder(const OpenEntry& a, const OpenEntry& b) {
+  if (a.f_cost != b.f_cost) return a.f_cost > b.f_cost;
+  return a.g_cost < b.g_cost;
+}
+
+// Directions to scan from a jump point reached moving in |direction|: on
+// from a horizontal run, or off it in either vertical direction; on from a
+// vertical run, or off it to a forced side.
+template <typename GridT>
+std::uint8_t JumpPointPathfinder::Successors(const GridT& grid, int cell, int direction) const {
+  std::uint8_t successors = 1 << direction;
+  if (!IsVertical(direction)) {
+    return successors | (1 << kUp) | (1 << kDown);
+  }
+  int behind = grid.Neighbour(cell, direction ^ 1);
+  for (int side : {kLeft, kRight}) {
+    if (!Blocked(grid.Neighbour(cell, side)) && Blocked(grid.Neighbour(behind, side))) {
+      successors |= 1 << side;
+    }
+  }
+  return successors;
+}
+
+// A vertical run must stop at |cell| when a side opens up that the cell
+// behind had blocked: a shortest path may turn there.
+template <typename GridT>
+bool JumpPointPathfinder::Forced(const GridT& grid, int cell, int direction) const {
+  int behind = grid.Neighbour(cell, direction ^ 1);
+  for (int side : {kLeft, kRight}) {
+    if (!Blocked(grid.Neighbour(cell, side)) && Blocked(grid.Neighbour(behind, side))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Next jump point from |cell| in |direction|, or -1 if the scan runs into
+// an obstacle or laps the board. |steps| receives its distance.
+template <typename GridT>
+int JumpPointPathfinder::Jump(const GridT& grid, int cell, int direction, int& steps) const {
+  if (IsVertical(direction)) {
+    return JumpVertical(grid, cell, direction, steps);
+  }
+  steps = 0;
+  for (int next = grid.Neighbour(cell, direction); next != cell;
+       next = grid.Neighbour(next, direction)) {
+    steps++;
+    if (Blocked(next)) return -1;
+    if (next == goal_cell_) return next;
+    int unused;
+    if (JumpVertical(grid, next, kUp, unused) >= 0 ||
+        JumpVertical(grid, next, kDown, unused) >= 0) {
+      return next;
+    }
+  }
+  return -1;
+}
+
+template <typename GridT>
+int JumpPointPathfinder::JumpVertical(const GridT& grid, int cell, int direction,
+                                      int& steps) const {
+  steps = 0;
+  for (int next = grid.Neighbour(cell, direction); next != cell;
+       next = grid.Neighbour(next, direction)) {
+    steps++;
+    if (Blocked(next)) return -1;
+    if (next == goal_cell_ || Forced(grid, next, direction)) return next;
+  }
+  return -1;
+}
+
+template <typename GridT>
+void JumpPointPathfinder::Relax(const GridT& grid, int parent, int cell, int g_cost,
+                                int direction) {
+  CellRecord& record = cells_[cell];
+  if (record.generation != generation_) {
+    record = CellRecord{};
+    record.g_cost = std::numeric_limits<int>::max();
+    record.generation = generation_;
+  }
+  std::uint8_t bit = 1 << direction;
+  if (g_cost < record.g_cost) {
+    record.g_cost = g_cost;
+    record.parent = parent;
+    record.parent_direction = static_cast<std::uint8_t>(direction);
+    record.arrived = bit;
+    record.expanded = 0;
+  } else if (g_cost == record.g_cost && !(record.arrived & bit)) {
+    record.arrived |= bit;
+  } else {
+    return;
+  }
+  open_heap_.push_back({g_cost + grid.Distance(cell, goal_cell_), g_cost, cell});
+  std::push_heap(open_heap_.begin(), open_heap_.end(), HeapOrder);
+}
+
+// Walks each straight run back from the goal, filling in the cells between
+// jump points.
+template <typename GridT>
+void JumpPointPathfinder::ReconstructPath(const GridT& grid, int start_cell,
+                                          std::vector<SDL_Point>& path) const {
+  int cell = goal_cell_;
+  while (cell != start_cell) {
+    const CellRecord& record = cells_[cell];
+    int back = record.parent_direction ^ 1;
+    for (int step = cell; step != record.parent; step = grid.Neighbour(step, back)) {
+      path.push_back({grid.X(step), grid.Y(step)});
+    }
+    cell = record.parent;
+  }
+  path.push_back({grid.X(start_cell), grid.Y(start_cell)});
+  std::reverse(path.begin(), path.end());
+}
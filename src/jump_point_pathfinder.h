@@ -0,0 +1,79 @@
+#ifndef JUMP_POINT_PATHFINDER_H
+#define JUMP_POINT_PATHFINDER_H
+
+#include <cstdint>
+#include <vector>
+#include "pathfinder.h"
+
+// Jump Point Search adapted to the 4-connected wrap-around grid. Among the
+// many equally short paths, only those that run horizontally first and turn
+// off a vertical run just past an obstacle corner are considered. A* then
+// expands only the cells where such a path can turn (jump points) and skips
+// over straight runs between them with cheap scans:
+//  - a vertical scan stops at the goal, or at a cell whose left or right
+//    neighbour is free while the one behind it was blocked;
+//  - a horizontal scan stops at the goal, or at a cell from which a vertical
+//    scan would stop somewhere.
+// Scans wrap around the board edges and give up after a full lap. The
+// heuristic is the Manhattan distance on the torus, so paths are shortest.
+class JumpPointPathfinder : public Pathfinder {
+ public:
+  JumpPointPathfinder(int grid_width, int grid_height);
+
+  bool FindPath(const SDL_Point& start, const SDL_Point& goal,
+                const std::vector<std::uint8_t>& blocked,
+                std::vector<SDL_Point>& path) override;
+
+ private:
+  // Search record for one jump point. |arrived| holds a bit per direction
+  // it was reached in at cost g_cost, plus kFromStart; |expanded| the ones
+  // whose successors have been generated. A cell reached the same way in
+  // two directions then expands the successors of both.
+  struct CellRecord {
+    int g_cost{0};
+    int parent{-1};
+    unsigned int generation{0};
+    std::uint8_t arrived{0};
+    std::uint8_t expanded{0};
+    // Direction of the straight run from |parent| to this cell.
+    std::uint8_t parent_direction{0};
+  };
+
+  struct OpenEntry {
+    int f_cost;
+    int g_cost;
+    int cell;
+  };
+
+  static constexpr std::uint8_t kFromStart = 1 << 4;
+
+  int grid_width_;
+  int grid_height_;
+  std::vector<CellRecord> cells_;
+  std::vector<OpenEntry> open_heap_;
+  unsigned int generation_{0};
+  // The search in progress.
+  const std::vector<std::uint8_t>* blocked_{nullptr};
+  int goal_cell_{0};
+
+  static bool HeapOrder(const OpenEntry& a, const OpenEntry& b);
+  void BeginSearch();
+  bool Blocked(int cell) const { return (*blocked_)[cell] != 0; }
+  // The search proper, over the board's Grid type (see grid.h).
+  template <typename GridT>
+  bool Search(const GridT& grid, int start_cell, std::vector<SDL_Point>& path);
+  template <typename GridT>
+  std::uint8_t Successors(const GridT& grid, int cell, int direction) const;
+  template <typename GridT>
+  bool Forced(const GridT& grid, int cell, int direction) const;
+  template <typename GridT>
+  int Jump(const GridT& grid, int cell, int direction, int& steps) const;
+  template <typename GridT>
+  int JumpVertical(const GridT& grid, int cell, int direction, int& steps) const;
+  template <typename GridT>
+  void Relax(const GridT& grid, int parent, int cell, int g_cost, int direction);
+  template <typename GridT>
+  void ReconstructPath(const GridT& grid, int start_cell, std::vector<SDL_Point>& path) const;
+};
+
+#endif
@@ -1,24 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
 #include "controller.h"
 #include "game.h"
 #include "renderer.h"
+#include "replay.h"
 
-int main() {
-  constexpr std::size_t kFramesPerSecond{60};
-  constexpr std::size_t kMsPerFrame{1000 / kFramesPerSecond};
+int main(int argc, char *argv[]) {
   constexpr std::size_t kScreenWidth{640};
   constexpr std::size_t kScreenHeight{640};
   constexpr std::size_t kGridWidth{32};
   constexpr std::size_t kGridHeight{32};
 
-  Renderer renderer(kScreenWidth, kScreenHeight, kGridWidth, kGridHeight);
+  GameConfig config;
+  config.grid_width = kGridWidth;
+  config.grid_height = kGridHeight;
+  std::string record_path;
+  std::string profile_path;
+  bool dirty_render = false;
+  bool vsync = true;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      config.seed = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      record_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+      profile_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--ai-snakes") == 0 && i + 1 < argc) {
+      config.ai_snakes = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+      config.grid_width = config.grid_height = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--dirty-render") == 0) {
+      dirty_render = true;
+    } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+      config.ticks_per_second = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--no-vsync") == 0) {
+      vsync = false;
+    } else if (std::strcmp(argv[i], "--pathfinder") == 0 && i + 1 < argc &&
+               ParsePathfinder(argv[i + 1], config.ai_pathfinder)) {
+      ++i;
+    } else if (std::strcmp(argv[i], "--mcts-budget") == 0 && i + 1 < argc) {
+      // The AI searches ahead for this many microseconds per move.
+      config.ai_planner = AIPlanner::kMcts;
+      config.mcts.budget = std::chrono::microseconds(std::atoi(argv[++i]));
+    } else {
+      std::cerr << "Usage: SnakeGame [--seed N] [--record FILE] [--profile CSV] [--ai-snakes N] "
+                   "[--grid N] [--dirty-render] [--tick-rate N] [--no-vsync] "
+                   "[--mcts-budget US] [--pathfinder astar|bfs|bidir|jps]\n"
+                   "The AI snakes' --mcts-budget searches together may take at most half a tick.\n";
+      return 1;
+    }
+  }
+  if (config.ticks_per_second < 1 || config.ticks_per_second > 1000) {
+    std::cerr << "--tick-rate must be between 1 and 1000\n";
+    return 1;
+  }
+  if (config.grid_width < GameConfig::kMinGridSize ||
+      config.grid_width > GameConfig::kMaxGridSize) {
+    std::cerr << "--grid must be between " << GameConfig::kMinGridSize << " and "
+              << GameConfig::kMaxGridSize << "\n";
+    return 1;
+  }
+  if (config.ai_snakes < 0 ||
+      static_cast<std::size_t>(config.ai_snakes) >= config.grid_width * config.grid_height / 2) {
+    std::cerr << "--ai-snakes must be between 0 and half the board\n";
+    return 1;
+  }
+
+  if (!record_path.empty() && config.ai_pathfinder != PathfinderEngine::kAStar) {
+    // Replays re-simulate the default AI.
+    std::cerr << "--record does not support --pathfinder\n";
+    return 1;
+  }
+  if (config.ai_planner == AIPlanner::kMcts) {
+    // Searches run on the game thread inside Update(), and every AI snake
+    // may decide in the same tick. Keep them to half a tick so rendering
+    // and input keep up.
+    long max_budget = 500000L / (config.ticks_per_second * std::max(config.ai_snakes, 1));
+    if (max_budget < 1) {
+      std::cerr << "--mcts-budget needs fewer --ai-snakes or a lower --tick-rate\n";
+      return 1;
+    }
+    if (config.mcts.budget.count() < 1 || config.mcts.budget.count() > max_budget) {
+      std::cerr << "--mcts-budget must be between 1 and " << max_budget
+                << " microseconds with " << config.ai_snakes << " AI snakes at "
+                << config.ticks_per_second << " ticks per second\n";
+      return 1;
+    }
+    if (!record_path.empty()) {
+      // Replays re-simulate the default AI, and a timed search is not
+      // reproducible anyway.
+      std::cerr << "--record does not support --mcts-budget\n";
+      return 1;
+    }
+  }
+
+  // Seeded sessions run deterministically: the AI is updated inline instead
+  // of by the pathfinding thread, so a recording replays bit for bit.
+  if (!record_path.empty() && !config.seed) {
+    config.seed = std::random_device{}();
+  }
+  if (config.seed) {
+    config.async_pathfinding = false;
+  }
+
+  Renderer renderer(kScreenWidth, kScreenHeight, config.grid_width, config.grid_height, vsync);
+  renderer.SetDirtyRendering(dirty_render);
   Controller controller;
-  Game game(kGridWidth, kGridHeight);
-  game.Run(controller, renderer, kMsPerFrame);
+  controller.SetRenderer(&renderer);
+  Game game(config);
+
+  // Frame phase histograms, written on exit and whenever F12 is pressed.
+  std::unique_ptr<FrameProfiler> profiler;
+  if (!profile_path.empty()) {
+    profiler = std::make_unique<FrameProfiler>(profile_path);
+    game.SetProfiler(profiler.get());
+    renderer.SetProfiler(profiler.get());
+    controller.SetProfiler(profiler.get());
+  }
+
+  if (record_path.empty()) {
+    game.Run(controller, renderer);
+  } else {
+    ReplayLog log;
+    log.seed = *config.seed;
+    log.grid_width = config.grid_width;
+    log.grid_height = config.grid_height;
+    log.ai_snakes = config.ai_snakes;
+    log.ticks_per_second = config.ticks_per_second;
+    RecordingInput recorder(controller, log);
+    game.Run(recorder, renderer);
+    recorder.Finish(game);
+    if (log.Save(record_path)) {
+      std::cout << "Recorded " << log.final_tick << " ticks to " << record_path << "\n";
+    }
+  }
+  if (profiler && profiler->WriteCsv()) {
+    std::cout << "Frame timings written to " << profile_path << "\n";
+  }
   std::cout << "Game has terminated successfully!\n";
   std::cout << "Player Score: " << game.GetPlayerScore() << "\n";
   std::cout << "Player Size: " << game.GetPlayerSize() << "\n";
   std::cout << "AI Score: " << game.GetAIScore() << "\n";
   std::cout << "AI Size: " << game.GetAISize() << "\n";
+  const LatencyHistogram &latency = controller.GetInputLatency();
+  if (latency.Count() > 0) {
+    std::cout << "Input latency (key press to move): p50 " << latency.Percentile(50.0) / 1e6
+              << " ms | p99 " << latency.Percentile(99.0) / 1e6 << " ms | max "
+              << latency.Max() / 1e6 << " ms\n";
+  }
   return 0;
 }
\ No newline at end of file
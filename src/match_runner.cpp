@@ -0,0 +1,191 @@
+#include "match_runner.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "input_policy.h"
+#include "simulation.h"
+
+namespace {
+
+template <std::size_t N>
+void Bump(std::array<std::uint64_t, N> &buckets, std::uint64_t value) {
+  buckets[std::min<std::uint64_t>(value, N - 1)]++;
+}
+
+int Log2Bucket(std::uint64_t value) {
+  int bucket = 0;
+  while (value > 1) {
+    value >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+template <std::size_t N>
+std::uint64_t Percentile(const std::array<std::uint64_t, N> &buckets, double fraction) {
+  std::uint64_t total = 0;
+  for (auto count : buckets) total += count;
+  if (total == 0) return 0;
+
+  std::uint64_t rank = static_cast<std::uint64_t>(fraction * (total - 1));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    seen += buckets[i];
+    if (seen > rank) return i;
+  }
+  return N - 1;
+}
+
+template <std::size_t N>
+void PrintDistribution(std::ostream &out, const char *name,
+                       const std::array<std::uint64_t, N> &buckets) {
+  out << "  " << name << ": p50 " << Percentile(buckets, 0.5)
+      << " | p90 " << Percentile(buckets, 0.9)
+      << " | p99 " << Percentile(buckets, 0.99)
+      << " | max " << Percentile(buckets, 1.0) << "\n";
+}
+
+}  // namespace
+
+MatchRunner::MatchRunner(const MatchRunnerConfig &config) : config_(config) {}
+
+MatchTally MatchRunner::Run() {
+  int threads = config_.threads;
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; ++i) {
+    workers.emplace_back(&MatchRunner::WorkerLoop, this);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // All workers are joined, so plain loads see every merged count.
+  MatchTally tally;
+  auto load = [](const auto &from, auto &to) {
+    for (std::size_t i = 0; i < from.size(); ++i) to[i] = from[i].load();
+  };
+  tally.matches = totals_.matches.load();
+  tally.player_wins = totals_.player_wins.load();
+  tally.ai_wins = totals_.ai_wins.load();
+  tally.ties = totals_.ties.load();
+  tally.unfinished = totals_.unfinished.load();
+  tally.board_full = totals_.board_full.load();
+  tally.total_ticks = totals_.total_ticks.load();
+  load(totals_.player_score, tally.player_score);
+  load(totals_.ai_score, tally.ai_score);
+  load(totals_.ticks_per_match, tally.ticks_per_match);
+  load(totals_.player_length_at_death, tally.player_length_at_death);
+  load(totals_.ai_length_at_death, tally.ai_length_at_death);
+  return tally;
+}
+
+void MatchRunner::WorkerLoop() {
+  MatchTally tally;
+  for (int match = next_match_.fetch_add(1, std::memory_order_relaxed);
+       match < config_.matches;
+       match = next_match_.fetch_add(1, std::memory_order_relaxed)) {
+    PlayMatch(match, tally);
+  }
+  Merge(tally);
+}
+
+void MatchRunner::PlayMatch(int match_index, MatchTally &tally) const {
+  GameConfig game_config;
+  game_config.grid_width = config_.grid_width;
+  game_config.grid_height = config_.grid_height;
+  game_config.async_pathfinding = false;
+  game_config.verbose = false;
+  game_config.seed = MatchSeed(config_.seed, match_index);
+  game_config.ai_snakes = config_.ai_snakes;
+  game_config.ai_avoid_traps = config_.ai_avoid_traps;
+  game_config.ai_planner = config_.ai_planner;
+  game_config.ai_pathfinder = config_.ai_pathfinder;
+  game_config.mcts = config_.mcts;
+
+  Game game(game_config);
+  BotInput input(config_.grid_width, config_.grid_height);
+  Simulation simulation(game, input);
+
+  RoundResult result;
+  if (simulation.RunRound(config_.max_ticks)) {
+    result = game.GetLastRound();
+    if (result.player_score > result.ai_score) {
+      tally.player_wins++;
+    } else if (result.ai_score > result.player_score) {
+      tally.ai_wins++;
+    } else {
+      tally.ties++;
+    }
+    if (result.board_full) {
+      tally.board_full++;
+    }
+  } else {
+    result.player_score = game.GetPlayerScore();
+    result.ai_score = game.GetAIScore();
+    result.player_size = game.GetPlayerSize();
+    result.ai_size = game.GetAISize();
+    result.ticks = game.GetTick();
+    tally.unfinished++;
+  }
+
+  tally.matches++;
+  tally.total_ticks += result.ticks;
+  Bump(tally.player_score, result.player_score);
+  Bump(tally.ai_score, result.ai_score);
+  Bump(tally.player_length_at_death, result.player_size);
+  Bump(tally.ai_length_at_death, result.ai_size);
+  Bump(tally.ticks_per_match, Log2Bucket(result.ticks));
+}
+
+void MatchRunner::Merge(const MatchTally &tally) {
+  constexpr auto kRelaxed = std::memory_order_relaxed;
+  auto merge = [](const auto &from, auto &to) {
+    for (std::size_t i = 0; i < from.size(); ++i) {
+      if (from[i] != 0) to[i].fetch_add(from[i], kRelaxed);
+    }
+  };
+  totals_.matches.fetch_add(tally.matches, kRelaxed);
+  totals_.player_wins.fetch_add(tally.player_wins, kRelaxed);
+  totals_.ai_wins.fetch_add(tally.ai_wins, kRelaxed);
+  totals_.ties.fetch_add(tally.ties, kRelaxed);
+  totals_.unfinished.fetch_add(tally.unfinished, kRelaxed);
+  totals_.board_full.fetch_add(tally.board_full, kRelaxed);
+  totals_.total_ticks.fetch_add(tally.total_ticks, kRelaxed);
+  merge(tally.player_score, totals_.player_score);
+  merge(tally.ai_score, totals_.ai_score);
+  merge(tally.ticks_per_match, totals_.ticks_per_match);
+  merge(tally.player_length_at_death, totals_.player_length_at_death);
+  merge(tally.ai_length_at_death, totals_.ai_length_at_death);
+}
+
+// SplitMix32-style finaliser so neighbouring match indices get unrelated
+// seeds while every match stays reproducible from (seed, index).
+std::uint32_t MatchRunner::MatchSeed(std::uint32_t seed, int match_index) {
+  std::uint32_t z = seed + 0x9E3779B9u * static_cast<std::uint32_t>(match_index + 1);
+  z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+  z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+  return z ^ (z >> 16);
+}
+
+void MatchRunner::PrintSummary(std::ostream &out, const MatchTally &tally) {
+  auto percent = [&](std::uint64_t count) {
+    return tally.matches ? 100.0 * count / tally.matches : 0.0;
+  };
+  out << "Matches: " << tally.matches << "\n";
+  out << "  player wins " << percent(tally.player_wins) << "% | AI wins "
+      << percent(tally.ai_wins) << "% | ties " << percent(tally.ties)
+      << "% | unfinished " << percent(tally.unfinished) << "%\n";
+  out << "  board filled: " << percent(tally.board_full) << "%\n";
+  out << "  mean ticks per match: "
+      << (tally.matches ? tally.total_ticks / tally.matches : 0) << "\n";
+  PrintDistribution(out, "player score", tally.player_score);
+  PrintDistribution(out, "AI score", tally.ai_score);
+  PrintDistribution(out, "player length at death", tally.player_length_at_death);
+  PrintDistribution(out, "AI length at death", tally.ai_length_at_death);
+  out << "  ticks per match (log2 bucket): p50 2^" << Percentile(tally.ticks_per_match, 0.5)
+      << " | p99 2^" << Percentile(tally.ticks_per_match, 0.99) << "\n";
+}
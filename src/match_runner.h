@@ -0,0 +1,77 @@
+#ifndef MATCH_RUNNER_H
+#define MATCH_RUNNER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include "game.h"
+
+struct MatchRunnerConfig {
+  int matches{1000};
+  // Worker threads; 0 uses std::thread::hardware_concurrency().
+  int threads{0};
+  std::uint32_t seed{1};
+  std::size_t grid_width{32};
+  std::size_t grid_height{32};
+  // Matches still running after this many ticks are counted as unfinished.
+  std::uint64_t max_ticks{100000};
+  int ai_snakes{1};
+  bool ai_avoid_traps{false};
+  AIPlanner ai_planner{AIPlanner::kAStar};
+  PathfinderEngine ai_pathfinder{PathfinderEngine::kAStar};
+  // Search settings for kMcts, per match.
+  MctsPlanner::Options mcts;
+};
+
+// Counters for a batch of matches. Workers fill a MatchCounters<std::uint64_t>
+// privately and merge it into the shared MatchCounters<std::atomic<...>> with
+// relaxed fetch_adds once they run out of work, so there is no lock and no
+// per-match contention.
+template <typename Counter>
+struct MatchCounters {
+  static constexpr int kScoreBuckets = 64;
+  static constexpr int kLengthBuckets = 256;
+  // ticks_per_match bucket i holds matches lasting [2^i, 2^(i+1)) ticks.
+  static constexpr int kTickBuckets = 64;
+
+  Counter matches{};
+  Counter player_wins{};
+  Counter ai_wins{};
+  Counter ties{};
+  Counter unfinished{};
+  // Finished matches that ended because the snakes filled the board.
+  Counter board_full{};
+  Counter total_ticks{};
+  // Values past the last bucket are clamped into it.
+  std::array<Counter, kScoreBuckets> player_score{};
+  std::array<Counter, kScoreBuckets> ai_score{};
+  std::array<Counter, kTickBuckets> ticks_per_match{};
+  std::array<Counter, kLengthBuckets> player_length_at_death{};
+  std::array<Counter, kLengthBuckets> ai_length_at_death{};
+};
+
+using MatchTally = MatchCounters<std::uint64_t>;
+
+class MatchRunner {
+ public:
+  explicit MatchRunner(const MatchRunnerConfig &config);
+
+  // Plays config.matches independent matches across the worker threads and
+  // returns the merged statistics.
+  MatchTally Run();
+
+  static void PrintSummary(std::ostream &out, const MatchTally &tally);
+
+ private:
+  MatchRunnerConfig config_;
+  std::atomic<int> next_match_{0};
+  MatchCounters<std::atomic<std::uint64_t>> totals_;
+
+  void WorkerLoop();
+  void PlayMatch(int match_index, MatchTally &tally) const;
+  void Merge(const MatchTally &tally);
+  static std::uint32_t MatchSeed(std::uint32_t seed, int match_index);
+};
+
+#endif
@@ -0,0 +1,402 @@
+#include "mcts_planner.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+// Cells each playout looks ahead.
+constexpr int kDepth = 40;
+// Tree size per worker; past it, leaves are played out but not expanded.
+constexpr std::size_t kMaxNodes = std::size_t{1} << 16;
+// UCT exploration weight, for rewards in [0, 1].
+constexpr float kExploration = 0.5f;
+// Chance, in percent, that a playout step heads for the food instead of
+// taking a random free neighbour.
+constexpr int kGreedyPercent = 75;
+// Slots of the per-playout table of entered cells; comfortably more than
+// the two snakes can enter in kDepth steps.
+constexpr std::size_t kEnteredSlots = 512;
+
+// Offsets in SnakeBase::Direction order: up, down, left, right. A
+// direction's opposite is its index with the low bit flipped.
+constexpr int kOffsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+
+constexpr int kSelf = 0;
+constexpr int kOpponent = 1;
+
+struct SimSnake {
+  int x;
+  int y;
+  int direction;
+  // Cells covered, including food eaten during the playout.
+  int length;
+  // Food eaten during the playout, which holds the tail back.
+  int growth;
+  bool alive;
+};
+
+// Where every playout of one decision starts.
+struct Position {
+  SimSnake snakes[2];
+  int snake_count;
+  int food;
+};
+
+}  // namespace
+
+// One search tree and the state of the playout running on it. Only ever
+// touched by its own thread while a search is running.
+struct MctsPlanner::Worker {
+  struct Node {
+    std::int32_t first_child{-1};
+    std::uint32_t visits{0};
+    float value{0};
+    std::uint8_t move{0};
+    std::uint8_t child_count{0};
+  };
+
+  // A cell a snake's head entered during the current playout.
+  struct Entered {
+    std::int32_t cell;
+    std::int32_t step;
+    std::uint32_t stamp;
+    std::uint8_t snake;
+  };
+
+  Worker(const MctsPlanner &planner, std::uint32_t seed, std::uint32_t index)
+      : planner_(planner), rng_(seed + index * 0x9e3779b9u) {
+    nodes_.reserve(1024);
+  }
+
+  void Search(const Position &root, const std::vector<std::uint8_t> &blocked,
+              std::chrono::steady_clock::time_point deadline, int limit) {
+    root_ = root;
+    blocked_ = &blocked;
+    nodes_.clear();
+    nodes_.push_back(Node{});
+    playouts_ = 0;
+    while (true) {
+      if (limit > 0) {
+        if (playouts_ >= static_cast<std::uint64_t>(limit)) break;
+      } else if (playouts_ > 0 && playouts_ % 8 == 0 &&
+                 std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      Iterate();
+      playouts_++;
+    }
+  }
+
+  const MctsPlanner &planner_;
+  std::mt19937 rng_;
+  std::vector<Node> nodes_;
+  std::vector<std::int32_t> path_;
+  std::array<Entered, kEnteredSlots> entered_{};
+  std::uint32_t entered_stamp_{0};
+  std::uint64_t playouts_{0};
+
+  Position root_{};
+  const std::vector<std::uint8_t> *blocked_{nullptr};
+  SimSnake snakes_[2]{};
+  int food_{-1};
+  int step_{0};
+  int ate_step_{-1};
+
+  // Selection down the tree, one expansion, a playout to kDepth and the
+  // backup of its reward along the path.
+  void Iterate() {
+    StartPlayout();
+    path_.clear();
+    path_.push_back(0);
+    int node = 0;
+    while (snakes_[kSelf].alive && step_ < kDepth) {
+      if (nodes_[node].child_count == 0) {
+        if ((node != 0 && nodes_[node].visits == 0) || nodes_.size() + 4 > kMaxNodes) break;
+        Expand(node);
+      }
+      node = Select(node);
+      path_.push_back(node);
+      Step(nodes_[node].move);
+    }
+    float reward = Playout();
+    for (int index : path_) {
+      nodes_[index].visits++;
+      nodes_[index].value += reward;
+    }
+  }
+
+  void StartPlayout() {
+    snakes_[kSelf] = root_.snakes[kSelf];
+    snakes_[kOpponent] = root_.snakes[kOpponent];
+    food_ = root_.food;
+    step_ = 0;
+    ate_step_ = -1;
+    if (++entered_stamp_ == 0) {
+      entered_.fill(Entered{});
+      entered_stamp_ = 1;
+    }
+  }
+
+  // Children are the moves open to the snake in the node's position; a
+  // move that turns out blocked in some playout simply scores a death.
+  void Expand(int node) {
+    const SimSnake &self = snakes_[kSelf];
+    nodes_[node].first_child = static_cast<std::int32_t>(nodes_.size());
+    for (int d = 0; d < 4; ++d) {
+      if (self.length > 1 && d == (self.direction ^ 1)) continue;
+      Node child;
+      child.move = static_cast<std::uint8_t>(d);
+      nodes_.push_back(child);
+      nodes_[node].child_count++;
+    }
+  }
+
+  // UCT: unvisited children first, then the best mean reward plus an
+  // exploration bonus that shrinks as a child is visited.
+  int Select(int node) const {
+    const Node &parent = nodes_[node];
+    float log_visits = std::log(static_cast<float>(parent.visits + 1));
+    int best = parent.first_child;
+    float best_score = -std::numeric_limits<float>::max();
+    for (int i = 0; i < parent.child_count; ++i) {
+      int index = parent.first_child + i;
+      const Node &child = nodes_[index];
+      if (child.visits == 0) return index;
+      float score = child.value / child.visits +
+                    kExploration * std::sqrt(log_visits / child.visits);
+      if (score > best_score) {
+        best_score = score;
+        best = index;
+      }
+    }
+    return best;
+  }
+
+  // Plays both snakes to kDepth and scores the result for the AI.
+  float Playout() {
+    while (snakes_[kSelf].alive && step_ < kDepth) {
+      Step(Policy(kSelf, step_ + 1));
+    }
+    int survived = snakes_[kSelf].alive ? kDepth : step_ - 1;
+    float reward = 0.4f * survived / kDepth;
+    if (ate_step_ >= 0) {
+      reward += 0.5f * (1.0f - 0.5f * ate_step_ / kDepth);
+    } else if (food_ >= 0) {
+      // No food within reach: credit getting closer to it.
+      int closer = Distance(root_.snakes[kSelf].x, root_.snakes[kSelf].y, food_) -
+                   Distance(snakes_[kSelf].x, snakes_[kSelf].y, food_);
+      reward += 0.25f * std::max(closer, 0) / kDepth;
+    }
+    if (root_.snake_count > 1 && !snakes_[kOpponent].alive) {
+      reward += 0.1f;
+    }
+    return reward;
+  }
+
+  // Advances one cell: the AI takes |move|, then the opponent its policy
+  // move, seeing the AI's new head as taken.
+  void Step(int move) {
+    step_++;
+    Move(kSelf, move);
+    if (root_.snake_count > 1 && snakes_[kOpponent].alive) {
+      Move(kOpponent, Policy(kOpponent, step_));
+    }
+  }
+
+  void Move(int index, int direction) {
+    SimSnake &snake = snakes_[index];
+    snake.direction = direction;
+    int x, y;
+    Neighbour(snake, direction, x, y);
+    int cell = y * planner_.grid_width_ + x;
+    if (!Free(cell, step_)) {
+      snake.alive = false;
+      return;
+    }
+    snake.x = x;
+    snake.y = y;
+    Enter(cell, index);
+    if (cell == food_) {
+      snake.growth++;
+      snake.length++;
+      food_ = -1;
+      if (index == kSelf) ate_step_ = step_;
+    }
+  }
+
+  // Mostly the free neighbour nearest the food, otherwise any free one, for
+  // the move made on |step|.
+  int Policy(int index, int step) {
+    const SimSnake &snake = snakes_[index];
+    int options[4];
+    int count = 0;
+    int best = -1;
+    int best_distance = std::numeric_limits<int>::max();
+    for (int d = 0; d < 4; ++d) {
+      if (snake.length > 1 && d == (snake.direction ^ 1)) continue;
+      int x, y;
+      Neighbour(snake, d, x, y);
+      if (!Free(y * planner_.grid_width_ + x, step)) continue;
+      options[count++] = d;
+      if (food_ >= 0) {
+        int distance = Distance(x, y, food_);
+        if (distance < best_distance) {
+          best_distance = distance;
+          best = d;
+        }
+      }
+    }
+    if (count == 0) {
+      return snake.direction;
+    }
+    if (best >= 0 && std::uniform_int_distribution<int>(1, 100)(rng_) <= kGreedyPercent) {
+      return best;
+    }
+    return options[std::uniform_int_distribution<int>(0, count - 1)(rng_)];
+  }
+
+  // Whether a head may enter |cell| on step |step|: nothing covers it, or
+  // the tail that did has moved on by then.
+  bool Free(int cell, int step) const {
+    if (const Entered *entry = FindEntered(cell)) {
+      return step - entry->step >= snakes_[entry->snake].length;
+    }
+    if (!(*blocked_)[cell]) {
+      return true;
+    }
+    if (planner_.release_stamp_[cell] != planner_.stamp_) {
+      return false;
+    }
+    const SimSnake &owner = snakes_[planner_.release_owner_[cell]];
+    return step >= planner_.release_[cell] + owner.growth;
+  }
+
+  void Enter(int cell, int index) {
+    std::size_t slot = Slot(cell);
+    while (entered_[slot].stamp == entered_stamp_ && entered_[slot].cell != cell) {
+      slot = (slot + 1) & (kEnteredSlots - 1);
+    }
+    entered_[slot] = Entered{cell, step_, entered_stamp_, static_cast<std::uint8_t>(index)};
+  }
+
+  const Entered *FindEntered(int cell) const {
+    std::size_t slot = Slot(cell);
+    while (entered_[slot].stamp == entered_stamp_) {
+      if (entered_[slot].cell == cell) return &entered_[slot];
+      slot = (slot + 1) & (kEnteredSlots - 1);
+    }
+    return nullptr;
+  }
+
+  static std::size_t Slot(int cell) {
+    return (static_cast<std::uint32_t>(cell) * 2654435761u) & (kEnteredSlots - 1);
+  }
+
+  void Neighbour(const SimSnake &snake, int direction, int &x, int &y) const {
+    x = snake.x + kOffsets[direction][0];
+    y = snake.y + kOffsets[direction][1];
+    if (x < 0) x += planner_.grid_width_;
+    if (x >= planner_.grid_width_) x -= planner_.grid_width_;
+    if (y < 0) y += planner_.grid_height_;
+    if (y >= planner_.grid_height_) y -= planner_.grid_height_;
+  }
+
+  // Steps between |x|, |y| and |cell| on the wrap-around grid.
+  int Distance(int x, int y, int cell) const {
+    int dx = std::abs(x - cell % planner_.grid_width_);
+    int dy = std::abs(y - cell / planner_.grid_width_);
+    return std::min(dx, planner_.grid_width_ - dx) + std::min(dy, planner_.grid_height_ - dy);
+  }
+};
+
+MctsPlanner::MctsPlanner(int grid_width, int grid_height, const Options &options,
+                         std::uint32_t seed)
+    : grid_width_(grid_width),
+      grid_height_(grid_height),
+      options_(options),
+      pool_(options.threads),
+      release_(static_cast<std::size_t>(grid_width) * grid_height, 0),
+      release_owner_(release_.size(), 0),
+      release_stamp_(release_.size(), 0) {
+  for (int i = 0; i < pool_.Size(); ++i) {
+    workers_.push_back(std::make_unique<Worker>(*this, seed, static_cast<std::uint32_t>(i)));
+  }
+}
+
+MctsPlanner::~MctsPlanner() = default;
+
+SnakeBase::Direction MctsPlanner::Decide(const std::vector<std::uint8_t> &blocked,
+                                         const SnakeBase &self, const SnakeBase *opponent,
+                                         const SDL_Point &food) {
+  if (++stamp_ == 0) {
+    std::fill(release_stamp_.begin(), release_stamp_.end(), 0);
+    stamp_ = 1;
+  }
+
+  auto make_sim = [](const SnakeBase &snake) {
+    SDL_Point head = snake.GetHeadCell();
+    return SimSnake{head.x, head.y, static_cast<int>(snake.direction), snake.GetSize(), 0,
+                    snake.IsAlive()};
+  };
+  Position root{};
+  root.snakes[kSelf] = make_sim(self);
+  root.snake_count = 1;
+  MarkBody(self, kSelf);
+  if (opponent && opponent->IsAlive()) {
+    root.snakes[kOpponent] = make_sim(*opponent);
+    root.snake_count = 2;
+    MarkBody(*opponent, kOpponent);
+  }
+  bool food_on_board = food.x >= 0 && food.x < grid_width_ && food.y >= 0 && food.y < grid_height_;
+  root.food = food_on_board ? food.y * grid_width_ + food.x : -1;
+
+  int threads = pool_.Size();
+  int limit = options_.playouts > 0 ? (options_.playouts + threads - 1) / threads : 0;
+  auto deadline = std::chrono::steady_clock::now() + options_.budget;
+  pool_.Run([&](int index) { workers_[index]->Search(root, blocked, deadline, limit); });
+
+  // Sum the root statistics of every tree, in worker order so a fixed
+  // playout count gives the same answer every time.
+  std::uint64_t visits[4] = {};
+  double value[4] = {};
+  for (const auto &worker : workers_) {
+    playouts_ += worker->playouts_;
+    const Worker::Node &top = worker->nodes_[0];
+    for (int i = 0; i < top.child_count; ++i) {
+      const Worker::Node &child = worker->nodes_[top.first_child + i];
+      visits[child.move] += child.visits;
+      value[child.move] += child.value;
+    }
+  }
+  decisions_++;
+
+  int best = -1;
+  for (int d = 0; d < 4; ++d) {
+    if (visits[d] == 0) continue;
+    if (best < 0 || visits[d] > visits[best] ||
+        (visits[d] == visits[best] && value[d] > value[best])) {
+      best = d;
+    }
+  }
+  return best < 0 ? self.direction : static_cast<SnakeBase::Direction>(best);
+}
+
+// Records when the tail leaves each of |snake|'s cells: the cell i places
+// from the tail is free from step i + 1, the head's from step size.
+void MctsPlanner::MarkBody(const SnakeBase &snake, std::uint8_t owner) {
+  const RingBuffer<SDL_Point> &body = snake.GetBody();
+  std::int32_t index = 0;
+  auto mark = [&](const SDL_Point &point) {
+    std::size_t cell = static_cast<std::size_t>(point.y) * grid_width_ + point.x;
+    release_[cell] = ++index;
+    release_owner_[cell] = owner;
+    release_stamp_[cell] = stamp_;
+  };
+  for (const SDL_Point &point : body) {
+    mark(point);
+  }
+  mark(snake.GetHeadCell());
+}
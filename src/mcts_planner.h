@@ -0,0 +1,74 @@
+#ifndef MCTS_PLANNER_H
+#define MCTS_PLANNER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "sdl_types.h"
+#include "snake_base.h"
+#include "thread_pool.h"
+
+// Monte Carlo tree search for an AI snake's next move. Every worker of a
+// thread pool grows its own search tree from the current position for a
+// fixed time budget (root parallelism), each iteration playing the snake and
+// the player a few dozen cells ahead on a cheap model of the grid; the root
+// visit counts are then summed to pick the move. More cores or a bigger
+// budget mean more playouts and better moves, so the budget is the AI's
+// difficulty setting.
+//
+// Playouts reward surviving, reaching the food first and leaving the player
+// with nowhere to go. Bodies shrink from the tail as the snakes move; other
+// AI snakes are treated as fixed obstacles.
+class MctsPlanner {
+ public:
+  struct Options {
+    // Worker threads, the calling thread included; 0 uses every core.
+    int threads{0};
+    // Wall-clock time spent on each decision.
+    std::chrono::microseconds budget{2000};
+    // When non-zero, run exactly this many playouts per decision instead of
+    // filling the budget. The result then no longer depends on machine load,
+    // so seeded games stay reproducible.
+    int playouts{0};
+  };
+
+  MctsPlanner(int grid_width, int grid_height, const Options &options, std::uint32_t seed);
+  ~MctsPlanner();
+  MctsPlanner(const MctsPlanner &) = delete;
+  MctsPlanner &operator=(const MctsPlanner &) = delete;
+
+  // Direction for |self| to leave its head cell in. |blocked| is non-zero for
+  // cells covered by any snake, indexed by y * grid_width + x. |opponent|,
+  // usually the player, may be null.
+  SnakeBase::Direction Decide(const std::vector<std::uint8_t> &blocked, const SnakeBase &self,
+                              const SnakeBase *opponent, const SDL_Point &food);
+
+  int GetThreads() const { return pool_.Size(); }
+  std::uint64_t GetDecisions() const { return decisions_; }
+  std::uint64_t GetPlayouts() const { return playouts_; }
+
+ private:
+  struct Worker;
+
+  int grid_width_;
+  int grid_height_;
+  Options options_;
+  ThreadPool pool_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // For the body cells of the two simulated snakes: how many steps until
+  // the tail leaves the cell, and which snake it belongs to. Entries are
+  // only valid where release_stamp_ matches stamp_, so a decision touches
+  // just the cells of the two bodies.
+  std::vector<std::int32_t> release_;
+  std::vector<std::uint8_t> release_owner_;
+  std::vector<std::uint32_t> release_stamp_;
+  std::uint32_t stamp_{0};
+  std::uint64_t decisions_{0};
+  std::uint64_t playouts_{0};
+
+  void MarkBody(const SnakeBase &snake, std::uint8_t owner);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include "pathfinder.h"
+#include "astar_pathfinder.h"
+#include "bfs_pathfinder.h"
+#include "bidirectional_pathfinder.h"
+#include "jump_point_pathfinder.h"
+
+namespace {
+
+struct EngineName {
+  PathfinderEngine engine;
+  const char* name;
+};
+
+constexpr EngineName kEngineNames[] = {
+    {PathfinderEngine::kAStar, "astar"},
+    {PathfinderEngine::kBfs, "bfs"},
+    {PathfinderEngine::kBidirectional, "bidir"},
+    {PathfinderEngine::kJumpPoint, "jps"},
+};
+
+}  // namespace
+
+std::unique_ptr<Pathfinder> MakePathfinder(PathfinderEngine engine, int grid_width,
+                                           int grid_height) {
+  switch (engine) {
+    case PathfinderEngine::kBfs:
+      return std::make_unique<BfsPathfinder>(grid_width, grid_height);
+    case PathfinderEngine::kBidirectional:
+      return std::make_unique<BidirectionalPathfinder>(grid_width, grid_height);
+    case PathfinderEngine::kJumpPoint:
+      return std::make_unique<JumpPointPathfinder>(grid_width, grid_height);
+    case PathfinderEngine::kAStar:
+      break;
+  }
+  return std::make_unique<AStarPathfinder>(grid_width, grid_height);
+}
+
+const char* PathfinderName(PathfinderEngine engine) {
+  for (const auto& entry : kEngineNames) {
+    if (entry.engine == engine) return entry.name;
+  }
+  return "astar";
+}
+
+bool ParsePathfinder(const std::string& name, PathfinderEngine& engine) {
+  for (const auto& entry : kEngineNames) {
+    if (name == entry.name) {
+      engine = entry.engine;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,48 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sdl_types.h"
+
+// Point-to-point search on the wrap-around 4-connected grid. Every engine
+// reads the same input, a flat grid of blocked cells, so they can be swapped
+// at runtime and compared on equal terms.
+class Pathfinder {
+ public:
+  virtual ~Pathfinder() = default;
+
+  // Path from |start| to |goal| that avoids every cell where |blocked| is
+  // non-zero (indexed by y * grid_width + x), both ends included. The start
+  // may itself be blocked, since it is usually a snake's head. Writes into
+  // |path| so its storage is reused; returns false (and leaves |path|
+  // empty) if the goal is unreachable.
+  virtual bool FindPath(const SDL_Point& start, const SDL_Point& goal,
+                        const std::vector<std::uint8_t>& blocked,
+                        std::vector<SDL_Point>& path) = 0;
+
+  // Number of cells expanded (popped and closed) by the last search.
+  int GetLastExpanded() const { return expanded_; }
+
+ protected:
+  int expanded_{0};
+};
+
+// Every engine returns a shortest path, though not always the same one when
+// several are equally short. kAStar is the heuristic search the AI has always
+// used. kBfs is a plain breadth-first search, cheapest per cell on small
+// boards. kBidirectional grows breadth-first frontiers from both ends and stops
+// where they meet. kJumpPoint is Jump Point Search, which expands only the
+// cells where a shortest path may turn.
+enum class PathfinderEngine { kAStar, kBfs, kBidirectional, kJumpPoint };
+
+std::unique_ptr<Pathfinder> MakePathfinder(PathfinderEngine engine, int grid_width,
+                                           int grid_height);
+// Command line name of |engine|: "astar", "bfs", "bidir" or "jps".
+const char* PathfinderName(PathfinderEngine engine);
+// Reverse of PathfinderName. Returns false for an unknown name.
+bool ParsePathfinder(const std::string& name, PathfinderEngine& engine);
+
+#endif
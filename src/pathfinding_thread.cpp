@@ -1,8 +1,11 @@
 #include "pathfinding_thread.h"
 #include <chrono>
 
-PathfindingThread::PathfindingThread(std::shared_ptr<GameState> game_state)
-    : game_state_(game_state) {}
+PathfindingThread::PathfindingThread(std::shared_ptr<GameState> game_state,
+                                     PathfinderEngine engine)
+    : game_state_(game_state),
+      pathfinder_(MakePathfinder(engine, game_state->GetGridWidth(),
+                                 game_state->GetGridHeight())) {}
 
 PathfindingThread::~PathfindingThread() {
   Stop();
@@ -27,10 +30,19 @@ void PathfindingThread::Stop() {
 }
 
 void PathfindingThread::NotifyStateChanged() {
-  state_changed_ = true;
+  {
+    // The worker only holds cv_mutex_ while checking the predicate, so this
+    // never waits on a search; taking it just closes the lost-wakeup window.
+    std::lock_guard<std::mutex> lock(cv_mutex_);
+    state_changed_ = true;
+  }
   cv_.notify_one();
 }
 
+const PathResult* PathfindingThread::PollResult() {
+  return results_.Acquire() ? &results_.ReadBuffer() : nullptr;
+}
+
 void PathfindingThread::WorkerLoop() {
   while (!should_stop_) {
     std::unique_lock<std::mutex> lock(cv_mutex_);
@@ -44,24 +56,32 @@ void PathfindingThread::WorkerLoop() {
     }
     
     if (state_changed_.exchange(false)) {
-      UpdateAIPath();
+      lock.unlock();
+      UpdateAIPaths();
     }
   }
 }
 
-void PathfindingThread::UpdateAIPath() {
+void PathfindingThread::UpdateAIPaths() {
   if (!game_state_) {
     return;
   }
-  
-  auto ai_snake = game_state_->GetAISnake();
-  if (!ai_snake || !ai_snake->IsAlive()) {
+
+  // The snapshot is owned by this thread until the next LatestSnapshot()
+  // call, so the main thread keeps publishing while we search.
+  const BoardSnapshot& snapshot = game_state_->LatestSnapshot();
+  if (snapshot.heads.size() < 2) {
     return;
   }
-  
-  SDL_Point food = game_state_->GetFood();
-  std::vector<const SnakeBase*> obstacles = game_state_->GetObstacles();
-  
-  ai_snake->SetTarget(food);
-  ai_snake->SetObstacles(obstacles);
-}
\ No newline at end of file
+
+  // Inner vectors are reused across results, so steady-state planning does
+  // not allocate.
+  PathResult& result = results_.WriteBuffer();
+  result.tick = snapshot.tick;
+  result.target = snapshot.food;
+  result.paths.resize(snapshot.heads.size() - 1);
+  for (std::size_t i = 1; i < snapshot.heads.size(); ++i) {
+    pathfinder_->FindPath(snapshot.heads[i], snapshot.food, snapshot.blocked, result.paths[i - 1]);
+  }
+  results_.Publish();
+}
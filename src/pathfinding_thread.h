@@ -6,16 +6,34 @@
 #include <mutex>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include "game_state.h"
+#include "pathfinder.h"
+#include "triple_buffer.h"
+
+// Paths computed on the worker, together with the snapshot they were
+// computed against. paths[i] belongs to the AI snake whose head was
+// snapshot.heads[i + 1].
+struct PathResult {
+  std::uint64_t tick{0};
+  SDL_Point target{0, 0};
+  std::vector<std::vector<SDL_Point>> paths;
+};
 
 class PathfindingThread {
  public:
-  PathfindingThread(std::shared_ptr<GameState> game_state);
+  PathfindingThread(std::shared_ptr<GameState> game_state,
+                    PathfinderEngine engine = PathfinderEngine::kAStar);
   ~PathfindingThread();
   
   void Start();
   void Stop();
+  // Asks the worker to plan against the latest board snapshot published
+  // through GameState.
   void NotifyStateChanged();
+  // Returns the newest result not yet taken, or nullptr. Main thread only;
+  // the returned result stays valid until the next call.
+  const PathResult* PollResult();
   
  private:
   std::shared_ptr<GameState> game_state_;
@@ -24,9 +42,11 @@ class PathfindingThread {
   std::mutex cv_mutex_;
   std::atomic<bool> should_stop_{false};
   std::atomic<bool> state_changed_{false};
+  std::unique_ptr<Pathfinder> pathfinder_;
+  TripleBuffer<PathResult> results_;
   
   void WorkerLoop();
-  void UpdateAIPath();
+  void UpdateAIPaths();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,14 +1,16 @@
 #include "renderer.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
 
 Renderer::Renderer(const std::size_t screen_width,
                    const std::size_t screen_height,
-                   const std::size_t grid_width, const std::size_t grid_height)
+                   const std::size_t grid_width, const std::size_t grid_height, bool vsync)
     : screen_width(screen_width),
       screen_height(screen_height),
       grid_width(grid_width),
-      grid_height(grid_height) {
+      grid_height(grid_height),
+      view_(screen_width, screen_height, grid_width, grid_height) {
   // Initialize SDL
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
     std::cerr << "SDL could not initialize.\n";
@@ -26,41 +28,87 @@ Renderer::Renderer(const std::size_t screen_width,
   }
 
   // Create renderer
-  sdl_renderer = SDL_CreateRenderer(sdl_window, -1, SDL_RENDERER_ACCELERATED);
+  Uint32 flags = SDL_RENDERER_ACCELERATED;
+  if (vsync) {
+    flags |= SDL_RENDERER_PRESENTVSYNC;
+  }
+  sdl_renderer = SDL_CreateRenderer(sdl_window, -1, flags);
   if (nullptr == sdl_renderer) {
     std::cerr << "Renderer could not be created.\n";
     std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
   }
+
+  // The driver may ignore the vsync request, so ask what was granted.
+  SDL_RendererInfo info;
+  if (sdl_renderer && SDL_GetRendererInfo(sdl_renderer, &info) == 0) {
+    vsync_ = (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+  }
+  SDL_DisplayMode mode;
+  int display = sdl_window ? SDL_GetWindowDisplayIndex(sdl_window) : -1;
+  if (display >= 0 && SDL_GetCurrentDisplayMode(display, &mode) == 0 && mode.refresh_rate > 0) {
+    refresh_rate_ = mode.refresh_rate;
+  }
 }
 
 Renderer::~Renderer() {
+  if (board_texture_) {
+    SDL_DestroyTexture(board_texture_);
+  }
   SDL_DestroyWindow(sdl_window);
   SDL_Quit();
 }
 
-void Renderer::Render(PlayerSnake const &player_snake, AISnake const &ai_snake, SDL_Point const &food) {
-  SDL_Rect block;
-  block.w = screen_width / grid_width;
-  block.h = screen_height / grid_height;
-
-  // Clear screen
-  SDL_SetRenderDrawColor(sdl_renderer, 0x1E, 0x1E, 0x1E, 0xFF);
-  SDL_RenderClear(sdl_renderer);
-
-  // Render food
-  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xCC, 0x00, 0xFF);
-  block.x = food.x * block.w;
-  block.y = food.y * block.h;
-  SDL_RenderFillRect(sdl_renderer, &block);
-
-  // Render player snake (blue)
-  RenderSnake(player_snake, 0x00, 0x7A, 0xCC, 0xFF);
-  
-  // Render AI snake (red)
-  RenderSnake(ai_snake, 0xFF, 0x00, 0x00, 0xFF);
+bool Renderer::Render(PlayerSnake const &player_snake,
+                      std::vector<std::shared_ptr<AISnake>> const &ai_snakes,
+                      SDL_Point const &food, std::vector<std::uint16_t> const &owners,
+                      float alpha) {
+  bool drawn;
+  {
+    ScopedPhaseTimer timer(profiler_, FrameProfiler::Phase::kRender);
+    view_.Update(player_snake, ai_snakes, food, owners, alpha);
+    drawn = dirty_rendering_ ? DrawChangedCells() : DrawAllCells();
+  }
+  if (profiler_) {
+    profiler_->Record(FrameProfiler::Counter::kDrawCalls, draw_calls_);
+    profiler_->Record(FrameProfiler::Counter::kRects, rects_);
+  }
+  if (!drawn) {
+    return false;
+  }
 
   // Update Screen
+  ScopedPhaseTimer timer(profiler_, FrameProfiler::Phase::kPresent);
+  auto present_start = std::chrono::steady_clock::now();
   SDL_RenderPresent(sdl_renderer);
+  present_time_ = std::chrono::steady_clock::now() - present_start;
+  return true;
+}
+
+void Renderer::SetDirtyRendering(bool enabled) {
+  if (!enabled) {
+    if (board_texture_) {
+      SDL_DestroyTexture(board_texture_);
+      board_texture_ = nullptr;
+    }
+    dirty_rendering_ = false;
+    return;
+  }
+  if (dirty_rendering_) {
+    return;
+  }
+  if (!SDL_RenderTargetSupported(sdl_renderer)) {
+    std::cerr << "Renderer cannot draw to textures; redrawing every frame.\n";
+    return;
+  }
+  board_texture_ = SDL_CreateTexture(sdl_renderer, SDL_PIXELFORMAT_RGBA8888,
+                                     SDL_TEXTUREACCESS_TARGET, screen_width, screen_height);
+  if (nullptr == board_texture_) {
+    std::cerr << "Board texture could not be created.\n";
+    std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+    return;
+  }
+  dirty_rendering_ = true;
+  full_repaint_ = true;
 }
 
 void Renderer::UpdateWindowTitle(int player_score, int ai_score, int fps) {
@@ -68,26 +116,129 @@ void Renderer::UpdateWindowTitle(int player_score, int ai_score, int fps) {
   SDL_SetWindowTitle(sdl_window, title.c_str());
 }
 
-void Renderer::RenderSnake(const SnakeBase &snake, Uint8 r, Uint8 g, Uint8 b, Uint8 a) const {
-  SDL_Rect block;
-  block.w = screen_width / grid_width;
-  block.h = screen_height / grid_height;
+// Queues the view's cells as rectangles, merging each horizontal run of
+// cells with the same colour. Background cells are only queued when |changed_only|,
+// which also skips every cell that already shows its colour.
+void Renderer::BatchRuns(bool changed_only) {
+  for (std::vector<SDL_Rect> &batch : batches_) {
+    batch.clear();
+  }
+  const std::vector<std::uint8_t> &colours = view_.Colours();
+  int columns = view_.Columns();
+  int cell_size = view_.CellSize();
+  for (int row = 0; row < view_.Rows(); ++row) {
+    std::size_t base = static_cast<std::size_t>(row) * columns;
+    int run_start = 0;
+    int run_batch = BoardView::kColourCount;
+    for (int column = 0; column <= columns; ++column) {
+      int batch = BoardView::kColourCount;
+      if (column < columns) {
+        std::uint8_t colour = colours[base + column];
+        bool draw = changed_only ? colour != shown_[base + column] : colour != BoardView::kBackground;
+        if (draw) batch = colour;
+      }
+      if (batch == run_batch) continue;
 
-  // Render snake's body
-  SDL_SetRenderDrawColor(sdl_renderer, r, g, b, a);
-  for (SDL_Point const &point : snake.GetBody()) {
-    block.x = point.x * block.w;
-    block.y = point.y * block.h;
-    SDL_RenderFillRect(sdl_renderer, &block);
+      if (run_batch != BoardView::kColourCount) {
+        batches_[run_batch].push_back({run_start * cell_size, row * cell_size,
+                                             (column - run_start) * cell_size, cell_size});
+      }
+      run_start = column;
+      run_batch = batch;
+    }
   }
+}
+
+// Queues the head markers into the batches of their colours.
+void Renderer::BatchHeads() {
+  for (const BoardView::HeadMarker &head : view_.Heads()) {
+    batches_[head.colour].push_back(head.rect);
+  }
+}
+
+// Draws every non-empty batch with one call each, after clearing the target
+// to the background colour when |clear| is set.
+void Renderer::SubmitBatches(bool clear) {
+  draw_calls_ = 0;
+  rects_ = 0;
+  if (clear) {
+    const SDL_Color &background = BoardView::kPalette[BoardView::kBackground];
+    SDL_SetRenderDrawColor(sdl_renderer, background.r, background.g, background.b, background.a);
+    SDL_RenderClear(sdl_renderer);
+    draw_calls_++;
+  }
+  for (int colour = 0; colour < BoardView::kColourCount; ++colour) {
+    const std::vector<SDL_Rect> &batch = batches_[colour];
+    if (batch.empty()) continue;
+    const SDL_Color &fill = BoardView::kPalette[colour];
+    SDL_SetRenderDrawColor(sdl_renderer, fill.r, fill.g, fill.b, fill.a);
+    SDL_RenderFillRects(sdl_renderer, batch.data(), static_cast<int>(batch.size()));
+    draw_calls_++;
+    rects_ += static_cast<int>(batch.size());
+  }
+}
+
+bool Renderer::DrawAllCells() {
+  BatchRuns(false);
+  BatchHeads();
+  SubmitBatches(true);
+  return true;
+}
+
+// Repaints the cells of board_texture_ whose colour differs from the view,
+// copies the texture to the screen and draws the head markers over it.
+// Returns false, having drawn nothing, when no cell changed and the markers
+// have not moved. shown_ is indexed by screen position, so scrolling only
+// repaints the cells whose colour on screen actually changes.
+bool Renderer::DrawChangedCells() {
+  const std::vector<std::uint8_t> &colours = view_.Colours();
+  bool repaint = full_repaint_ || view_.CellSize() != shown_cell_size_ ||
+                 shown_.size() != colours.size();
+  if (repaint) {
+    shown_.assign(colours.size(), BoardView::kBackground);
+  }
+  BatchRuns(true);
 
-  // Render snake's head
-  block.x = static_cast<int>(snake.GetHeadX()) * block.w;
-  block.y = static_cast<int>(snake.GetHeadY()) * block.h;
-  if (snake.IsAlive()) {
-    SDL_SetRenderDrawColor(sdl_renderer, r, g, b, a);
-  } else {
-    SDL_SetRenderDrawColor(sdl_renderer, 0x80, 0x80, 0x80, 0xFF);
+  bool changed = repaint;
+  for (const std::vector<SDL_Rect> &batch : batches_) {
+    changed |= !batch.empty();
   }
-  SDL_RenderFillRect(sdl_renderer, &block);
+  const std::vector<BoardView::HeadMarker> &heads = view_.Heads();
+  bool heads_moved =
+      heads.size() != shown_heads_.size() ||
+      !std::equal(heads.begin(), heads.end(), shown_heads_.begin(),
+                  [](const BoardView::HeadMarker &a, const BoardView::HeadMarker &b) {
+                    return a.colour == b.colour && a.rect.x == b.rect.x && a.rect.y == b.rect.y &&
+                           a.rect.w == b.rect.w && a.rect.h == b.rect.h;
+                  });
+  if (!changed && !heads_moved) {
+    draw_calls_ = 0;
+    rects_ = 0;
+    return false;
+  }
+
+  int draw_calls = 0;
+  int rects = 0;
+  if (changed) {
+    SDL_SetRenderTarget(sdl_renderer, board_texture_);
+    SubmitBatches(repaint);
+    SDL_SetRenderTarget(sdl_renderer, nullptr);
+    draw_calls = draw_calls_;
+    rects = rects_;
+  }
+  SDL_RenderCopy(sdl_renderer, board_texture_, nullptr, nullptr);
+
+  for (std::vector<SDL_Rect> &batch : batches_) {
+    batch.clear();
+  }
+  BatchHeads();
+  SubmitBatches(false);
+  draw_calls_ += draw_calls + 1;
+  rects_ += rects;
+
+  shown_ = colours;
+  shown_heads_ = heads;
+  full_repaint_ = false;
+  shown_cell_size_ = view_.CellSize();
+  return true;
 }
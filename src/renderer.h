@@ -1,30 +1,97 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include "SDL.h"
 #include "player_snake.h"
 #include "ai_snake.h"
+#include "board_view.h"
+#include "frame_profiler.h"
 
 class Renderer {
  public:
+  // With |vsync|, presenting a frame waits for the display's next refresh,
+  // if the driver supports it.
   Renderer(const std::size_t screen_width, const std::size_t screen_height,
-           const std::size_t grid_width, const std::size_t grid_height);
+           const std::size_t grid_width, const std::size_t grid_height, bool vsync = true);
   ~Renderer();
 
-  void Render(PlayerSnake const &player_snake, AISnake const &ai_snake, SDL_Point const &food);
+  // Draws the cells in view and the head markers |alpha| of the way into the
+  // next tick (see BoardView::Update). Returns false if the frame was
+  // skipped without presenting.
+  bool Render(PlayerSnake const &player_snake,
+              std::vector<std::shared_ptr<AISnake>> const &ai_snakes, SDL_Point const &food,
+              std::vector<std::uint16_t> const &owners, float alpha = 1.0f);
   void UpdateWindowTitle(int player_score, int ai_score, int fps);
+  // True if SDL_RenderPresent waits for vertical sync.
+  bool HasVsync() const { return vsync_; }
+  // Refresh rate of the window's display in Hz, 60 if SDL does not know it.
+  int GetRefreshRate() const { return refresh_rate_; }
+
+  // See BoardView for the zoom levels and how the view follows the player.
+  void ZoomIn() { view_.ZoomIn(); }
+  void ZoomOut() { view_.ZoomOut(); }
+  int GetCellSize() const { return view_.CellSize(); }
+  // Keeps the board in a render-target texture and repaints only the cells
+  // whose colour changed since the last frame (head moves, tail removal,
+  // food, deaths, scrolling); a frame where nothing changed is neither drawn
+  // nor presented. Falls back to full redraws if the renderer cannot draw to
+  // textures.
+  void SetDirtyRendering(bool enabled);
+  // Repaints the whole board on the next frame, e.g. after the window was
+  // exposed or SDL dropped the contents of render targets.
+  void Invalidate() { full_repaint_ = true; }
+  // SDL draw calls (clear, texture copy and one per non-empty colour batch)
+  // and rectangles submitted by the last Render; 0 for a skipped frame.
+  int GetLastDrawCalls() const { return draw_calls_; }
+  int GetLastRects() const { return rects_; }
+  // Time the last presented frame spent in SDL_RenderPresent; with vsync,
+  // mostly waiting for the refresh.
+  std::chrono::steady_clock::duration GetLastPresentTime() const { return present_time_; }
+  // Times draw submission and SDL_RenderPresent separately when set.
+  void SetProfiler(FrameProfiler *profiler) { profiler_ = profiler; }
 
  private:
   SDL_Window *sdl_window;
   SDL_Renderer *sdl_renderer;
+  FrameProfiler *profiler_{nullptr};
+  bool vsync_{false};
+  int refresh_rate_{60};
 
   const std::size_t screen_width;
   const std::size_t screen_height;
   const std::size_t grid_width;
   const std::size_t grid_height;
-  
-  void RenderSnake(const SnakeBase &snake, Uint8 r, Uint8 g, Uint8 b, Uint8 a) const;
+
+  BoardView view_;
+
+  // Rectangles of each BoardView::Colour, submitted with a single
+  // SDL_RenderFillRects per colour. The buffers are cleared, not freed,
+  // between frames, so drawing stops allocating once they have grown to the
+  // busiest frame.
+  std::array<std::vector<SDL_Rect>, BoardView::kColourCount> batches_;
+  int draw_calls_{0};
+  std::chrono::steady_clock::duration present_time_{0};
+  int rects_{0};
+
+  // BoardView colours as last painted into board_texture_.
+  std::vector<std::uint8_t> shown_;
+  SDL_Texture *board_texture_{nullptr};
+  bool dirty_rendering_{false};
+  bool full_repaint_{true};
+  int shown_cell_size_{0};
+  // Head markers drawn over board_texture_ in the last presented frame.
+  std::vector<BoardView::HeadMarker> shown_heads_;
+
+  void BatchRuns(bool changed_only);
+  void BatchHeads();
+  void SubmitBatches(bool clear);
+  bool DrawAllCells();
+  bool DrawChangedCells();
 };
 
 #endif
@@ -0,0 +1,204 @@
+#include "replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include "game.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'N', 'K', 'R'};
+constexpr std::uint8_t kVersion = 6;
+// Older logs were recorded with a different food placement or movement
+// model, or with A* ignoring the wrap-around in its heuristic, so they can
+// no longer be re-simulated.
+constexpr std::uint8_t kOldestReplayable = 6;
+
+void PutU32(std::ostream &out, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) out.put(static_cast<char>(value >> (8 * i)));
+}
+
+void PutU64(std::ostream &out, std::uint64_t value) {
+  for (int i = 0; i < 8; ++i) out.put(static_cast<char>(value >> (8 * i)));
+}
+
+void PutVarint(std::ostream &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.put(static_cast<char>(value));
+}
+
+bool GetU32(std::istream &in, std::uint32_t &value) {
+  value = 0;
+  for (int i = 0; i < 4; ++i) {
+    int byte = in.get();
+    if (byte == EOF) return false;
+    value |= static_cast<std::uint32_t>(byte) << (8 * i);
+  }
+  return true;
+}
+
+bool GetU64(std::istream &in, std::uint64_t &value) {
+  value = 0;
+  for (int i = 0; i < 8; ++i) {
+    int byte = in.get();
+    if (byte == EOF) return false;
+    value |= static_cast<std::uint64_t>(byte) << (8 * i);
+  }
+  return true;
+}
+
+bool GetVarint(std::istream &in, std::uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int byte = in.get();
+    if (byte == EOF) return false;
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool ReplayLog::Save(const std::string &path) const {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    std::cerr << "Could not open replay file " << path << " for writing.\n";
+    return false;
+  }
+
+  out.write(kMagic, sizeof(kMagic));
+  out.put(static_cast<char>(kVersion));
+  PutU32(out, seed);
+  PutU32(out, grid_width);
+  PutU32(out, grid_height);
+  PutU32(out, ai_snakes);
+  PutU32(out, ticks_per_second);
+
+  PutVarint(out, events.size());
+  std::uint64_t previous_tick = 0;
+  for (const auto &event : events) {
+    PutVarint(out, (event.tick - previous_tick) << 2 | static_cast<std::uint64_t>(event.direction));
+    previous_tick = event.tick;
+  }
+
+  PutVarint(out, checkpoints.size());
+  for (auto hash : checkpoints) PutU64(out, hash);
+
+  PutVarint(out, final_tick);
+  PutU64(out, final_hash);
+  return static_cast<bool>(out);
+}
+
+bool ReplayLog::Load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    std::cerr << "Could not open replay file " << path << ".\n";
+    return false;
+  }
+
+  char magic[sizeof(kMagic)];
+  in.read(magic, sizeof(magic));
+  int version = in.get();
+  if (!in || !std::equal(magic, magic + sizeof(magic), kMagic) || version < 1 ||
+      version > kVersion) {
+    std::cerr << path << " is not a replay file.\n";
+    return false;
+  }
+  if (version < kOldestReplayable) {
+    std::cerr << path << " was recorded by an older version of the game and cannot be "
+              << "replayed.\n";
+    return false;
+  }
+
+  std::uint64_t count;
+  bool ok = GetU32(in, seed) && GetU32(in, grid_width) && GetU32(in, grid_height) &&
+            GetU32(in, ai_snakes) && GetU32(in, ticks_per_second) && ticks_per_second > 0 &&
+            GetVarint(in, count);
+  if (ok && (grid_width < GameConfig::kMinGridSize || grid_width > GameConfig::kMaxGridSize ||
+             grid_height < GameConfig::kMinGridSize || grid_height > GameConfig::kMaxGridSize)) {
+    std::cerr << "Replay file " << path << " has an unsupported board size.\n";
+    return false;
+  }
+  // The bound --ai-snakes is held to when recording.
+  if (ok && ai_snakes >= std::size_t{grid_width} * grid_height / 2) {
+    std::cerr << "Replay file " << path << " has an unsupported AI snake count.\n";
+    return false;
+  }
+  events.clear();
+  std::uint64_t tick = 0;
+  for (std::uint64_t i = 0; ok && i < count; ++i) {
+    std::uint64_t packed;
+    ok = GetVarint(in, packed);
+    tick += packed >> 2;
+    events.push_back({tick, static_cast<SnakeBase::Direction>(packed & 3)});
+  }
+
+  ok = ok && GetVarint(in, count);
+  checkpoints.clear();
+  for (std::uint64_t i = 0; ok && i < count; ++i) {
+    std::uint64_t hash;
+    ok = GetU64(in, hash);
+    checkpoints.push_back(hash);
+  }
+
+  ok = ok && GetVarint(in, final_tick) && GetU64(in, final_hash);
+  if (!ok) {
+    std::cerr << "Replay file " << path << " is truncated.\n";
+  }
+  return ok;
+}
+
+RecordingInput::RecordingInput(InputPolicy &inner, ReplayLog &log)
+    : inner_(inner), log_(log) {}
+
+bool RecordingInput::Apply(const Game &game, PlayerSnake &snake) {
+  if (game.GetTick() % ReplayLog::kCheckpointInterval == 0) {
+    log_.checkpoints.push_back(game.StateHash());
+  }
+
+  SnakeBase::Direction before = snake.direction;
+  bool running = inner_.Apply(game, snake);
+  if (snake.direction != before) {
+    log_.events.push_back({game.GetTick(), snake.direction});
+  }
+  return running;
+}
+
+void RecordingInput::Finish(const Game &game) {
+  log_.final_tick = game.GetTick();
+  log_.final_hash = game.StateHash();
+}
+
+ReplayInput::ReplayInput(const ReplayLog &log) : log_(log) {}
+
+bool ReplayInput::Apply(const Game &game, PlayerSnake &snake) {
+  std::uint64_t tick = game.GetTick();
+  if (tick >= log_.final_tick) {
+    return false;
+  }
+
+  if (tick % ReplayLog::kCheckpointInterval == 0 && !first_mismatch_) {
+    std::size_t index = tick / ReplayLog::kCheckpointInterval;
+    if (index < log_.checkpoints.size() && log_.checkpoints[index] != game.StateHash()) {
+      first_mismatch_ = tick;
+    }
+  }
+
+  // Recorded directions are the result of the live input, so they are set
+  // as-is rather than re-validated against the reversal rule.
+  while (next_event_ < log_.events.size() && log_.events[next_event_].tick <= tick) {
+    snake.direction = log_.events[next_event_].direction;
+    next_event_++;
+  }
+  return true;
+}
+
+bool ReplayInput::Verify(const Game &game) {
+  if (!first_mismatch_ && game.StateHash() != log_.final_hash) {
+    first_mismatch_ = game.GetTick();
+  }
+  return !first_mismatch_ && game.GetTick() == log_.final_tick;
+}
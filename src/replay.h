@@ -0,0 +1,76 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "game.h"
+#include "input_policy.h"
+#include "snake_base.h"
+
+// Everything needed to re-simulate a deterministic session: the master seed,
+// board size, AI snake count, tick rate and the player's direction changes
+// keyed by tick, plus state hashes taken every kCheckpointInterval ticks and
+// at the very end.
+//
+// On disk: "SNKR", a version byte, seed, grid size, AI snake count and tick
+// rate as little-endian u32, then LEB128 varints. Each direction change is
+// one varint holding (ticks since previous change << 2 | direction), usually
+// a single byte. Versions before 5 simulated differently and are rejected.
+struct ReplayLog {
+  struct Event {
+    std::uint64_t tick;
+    SnakeBase::Direction direction;
+  };
+
+  static constexpr std::uint64_t kCheckpointInterval = 1024;
+
+  std::uint32_t seed{0};
+  std::uint32_t grid_width{0};
+  std::uint32_t grid_height{0};
+  std::uint32_t ai_snakes{1};
+  std::uint32_t ticks_per_second{GameConfig::kBaseTicksPerSecond};
+  std::vector<Event> events;
+  // checkpoints[i] is Game::StateHash() before tick i * kCheckpointInterval.
+  std::vector<std::uint64_t> checkpoints;
+  std::uint64_t final_tick{0};
+  std::uint64_t final_hash{0};
+
+  bool Save(const std::string &path) const;
+  bool Load(const std::string &path);
+};
+
+// Wraps another policy and logs every direction change it makes.
+class RecordingInput : public InputPolicy {
+ public:
+  RecordingInput(InputPolicy &inner, ReplayLog &log);
+
+  bool Apply(const Game &game, PlayerSnake &snake) override;
+  // Stamps the final tick and state hash. Call once the session is over.
+  void Finish(const Game &game);
+
+ private:
+  InputPolicy &inner_;
+  ReplayLog &log_;
+};
+
+// Feeds a recorded session back into a Game built from the same seed and
+// grid, checking every checkpoint hash on the way. Stops at the final tick.
+class ReplayInput : public InputPolicy {
+ public:
+  explicit ReplayInput(const ReplayLog &log);
+
+  bool Apply(const Game &game, PlayerSnake &snake) override;
+  // True if every checkpoint and the final hash matched.
+  bool Verify(const Game &game);
+  // Tick of the first checkpoint that did not match, if any.
+  std::optional<std::uint64_t> FirstMismatch() const { return first_mismatch_; }
+
+ private:
+  const ReplayLog &log_;
+  std::size_t next_event_{0};
+  std::optional<std::uint64_t> first_mismatch_;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// Circular FIFO store with O(1) push_back and pop_front. Capacity is a power
+// of two so positions wrap with a mask; when full the storage doubles, so a
+// buffer that has reached its working size never allocates again.
+template <typename T>
+class RingBuffer {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator(const RingBuffer* buffer, std::size_t index)
+        : buffer_(buffer), index_(index) {}
+
+    reference operator*() const { return (*buffer_)[index_]; }
+    pointer operator->() const { return &(*buffer_)[index_]; }
+    const_iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      ++index_;
+      return previous;
+    }
+    bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+   private:
+    const RingBuffer* buffer_;
+    std::size_t index_;
+  };
+
+  explicit RingBuffer(std::size_t initial_capacity = 16) {
+    std::size_t capacity = 1;
+    while (capacity < initial_capacity) capacity <<= 1;
+    Reallocate(capacity);
+  }
+
+  RingBuffer(const RingBuffer& other) { *this = other; }
+  RingBuffer& operator=(const RingBuffer& other) {
+    if (this != &other) {
+      clear();
+      Reallocate(other.capacity_);
+      for (std::size_t i = 0; i < other.size_; ++i) {
+        data_[i] = other[i];
+      }
+      size_ = other.size_;
+    }
+    return *this;
+  }
+  // A moved-from buffer is left empty with no storage; it allocates again on
+  // its next push_back.
+  RingBuffer(RingBuffer&& other) noexcept { *this = std::move(other); }
+  RingBuffer& operator=(RingBuffer&& other) noexcept {
+    if (this != &other) {
+      data_ = std::move(other.data_);
+      capacity_ = other.capacity_;
+      mask_ = other.mask_;
+      head_ = other.head_;
+      size_ = other.size_;
+      other.capacity_ = 0;
+      other.mask_ = 0;
+      other.head_ = 0;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  void push_back(const T& value) {
+    if (size_ == capacity_) Reallocate(capacity_ == 0 ? 1 : capacity_ * 2);
+    data_[(head_ + size_) & mask_] = value;
+    ++size_;
+  }
+
+  void pop_front() {
+    head_ = (head_ + 1) & mask_;
+    --size_;
+  }
+
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  const T& front() const { return data_[head_]; }
+  const T& back() const { return data_[(head_ + size_ - 1) & mask_]; }
+  const T& operator[](std::size_t i) const { return data_[(head_ + i) & mask_]; }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size_); }
+
+ private:
+  std::unique_ptr<T[]> data_;
+  std::size_t capacity_{0};
+  std::size_t mask_{0};
+  std::size_t head_{0};
+  std::size_t size_{0};
+
+  // Grows (or initialises) the storage and unrolls the contents so the
+  // oldest element sits at index 0.
+  void Reallocate(std::size_t capacity) {
+    std::unique_ptr<T[]> data(new T[capacity]);
+    for (std::size_t i = 0; i < size_; ++i) {
+      data[i] = (*this)[i];
+    }
+    data_ = std::move(data);
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    head_ = 0;
+  }
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SDL_TYPES_H
+#define SDL_TYPES_H
+
+// The plain SDL structs the game core passes around. The core never calls
+// into SDL, so SnakeSim builds without it: where SDL's headers are missing,
+// these stand-ins with the same layout take their place.
+#if __has_include("SDL.h")
+#include "SDL.h"
+#else
+#include <cstdint>
+
+struct SDL_Point {
+  int x;
+  int y;
+};
+
+struct SDL_Rect {
+  int x, y;
+  int w, h;
+};
+
+struct SDL_Color {
+  std::uint8_t r;
+  std::uint8_t g;
+  std::uint8_t b;
+  std::uint8_t a;
+};
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+#include "simulation.h"
+#include <iostream>
+
+Simulation::Simulation(Game &game, InputPolicy &input)
+    : game_(game), input_(input) {}
+
+std::uint64_t Simulation::Run(std::uint64_t ticks) {
+  std::uint64_t simulated = 0;
+  while (simulated < ticks) {
+    if (!input_.Apply(game_, game_.GetPlayerSnake())) {
+      break;
+    }
+    Tick();
+    simulated++;
+  }
+  return simulated;
+}
+
+bool Simulation::RunRound(std::uint64_t max_ticks) {
+  int round = game_.GetRoundsPlayed();
+  for (std::uint64_t i = 0; i < max_ticks; ++i) {
+    if (!input_.Apply(game_, game_.GetPlayerSnake())) {
+      return false;
+    }
+    Tick();
+    if (game_.GetRoundsPlayed() != round) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Simulation::Tick() {
+  game_.Update();
+  if (renderer_ && !renderer_->Render(game_.GetPlayerSnake(), game_.GetAISnakes(),
+                                      game_.GetFood(), game_.GetOwners())) {
+    std::cerr << "Video output stopped at tick " << game_.GetTick() << "\n";
+    renderer_ = nullptr;
+  }
+}
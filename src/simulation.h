@@ -0,0 +1,38 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include "game.h"
+#include "input_policy.h"
+#include "software_renderer.h"
+
+// Headless driver for Game: steps Game::Update() back to back with input from
+// an InputPolicy. No window and no frame pacing are involved; frames are only
+// drawn if a SoftwareRenderer is attached.
+class Simulation {
+ public:
+  Simulation(Game &game, InputPolicy &input);
+
+  // Advances the game by up to |ticks| ticks. Stops early if the input
+  // policy asks to quit. Returns the number of ticks actually simulated.
+  std::uint64_t Run(std::uint64_t ticks);
+
+  // Advances the game until the current round ends, for at most |max_ticks|
+  // ticks. Returns true if the round ended; its outcome is then available
+  // from Game::GetLastRound().
+  bool RunRound(std::uint64_t max_ticks);
+
+  // Draws a frame after every tick when set, e.g. to record a video. If the
+  // video output fails, the renderer is dropped and the run goes on without
+  // frames.
+  void SetRenderer(SoftwareRenderer *renderer) { renderer_ = renderer; }
+
+ private:
+  Game &game_;
+  InputPolicy &input_;
+  SoftwareRenderer *renderer_{nullptr};
+
+  void Tick();
+};
+
+#endif
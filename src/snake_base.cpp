@@ -1,54 +1,118 @@
 #include "snake_base.h"
-#include <cmath>
+#include <algorithm>
 #include <iostream>
+#include "state_hash.h"
 
 SnakeBase::SnakeBase(int grid_width, int grid_height)
     : grid_width(grid_width),
       grid_height(grid_height),
-      head_x(grid_width / 2),
-      head_y(grid_height / 2) {}
+      head{grid_width / 2, grid_height / 2},
+      prev_head(head),
+      occupancy(static_cast<std::size_t>(grid_width) * grid_height, 0) {
+  occupancy[CellIndex(head.x, head.y)] = 1;
+}
 
 void SnakeBase::ChangeDirection(Direction input, Direction opposite) {
   if (direction != opposite || size == 1) direction = input;
 }
 
-void SnakeBase::UpdateHead() {
+SnakeBase::Direction SnakeBase::Opposite(Direction direction) {
+  switch (direction) {
+    case Direction::kUp: return Direction::kDown;
+    case Direction::kDown: return Direction::kUp;
+    case Direction::kLeft: return Direction::kRight;
+    case Direction::kRight: return Direction::kLeft;
+  }
+  return direction;
+}
+
+// Wraps with a compare and an add or subtract instead of a modulo, since the
+// head only ever moves one cell.
+bool SnakeBase::UpdateHead() {
+  std::int32_t step = ticks_per_second == kBaseTicksPerSecond
+                          ? speed
+                          : speed * kBaseTicksPerSecond / ticks_per_second;
+  progress += std::min(step, kCellUnits);
+  if (progress < kCellUnits) {
+    return false;
+  }
+  progress -= kCellUnits;
+
   switch (direction) {
     case Direction::kUp:
-      head_y -= speed;
+      if (--head.y < 0) head.y += grid_height;
       break;
 
     case Direction::kDown:
-      head_y += speed;
+      if (++head.y == grid_height) head.y = 0;
       break;
 
     case Direction::kLeft:
-      head_x -= speed;
+      if (--head.x < 0) head.x += grid_width;
       break;
 
     case Direction::kRight:
-      head_x += speed;
+      if (++head.x == grid_width) head.x = 0;
       break;
   }
+  return true;
+}
+
+namespace {
+
+// |cell| moved |progress| of a cell along |direction|'s x or y axis.
+float Position(int cell, std::int32_t progress, int sign) {
+  return cell + sign * static_cast<float>(progress) / SnakeBase::kCellUnits;
+}
+
+int XSign(SnakeBase::Direction direction) {
+  return direction == SnakeBase::Direction::kRight ? 1
+         : direction == SnakeBase::Direction::kLeft ? -1
+                                                    : 0;
+}
 
-  head_x = fmod(head_x + grid_width, grid_width);
-  head_y = fmod(head_y + grid_height, grid_height);
+int YSign(SnakeBase::Direction direction) {
+  return direction == SnakeBase::Direction::kDown ? 1
+         : direction == SnakeBase::Direction::kUp ? -1
+                                                  : 0;
+}
+
+}  // namespace
+
+float SnakeBase::GetHeadPositionX() const {
+  return Position(head.x, progress, XSign(direction));
+}
+
+float SnakeBase::GetHeadPositionY() const {
+  return Position(head.y, progress, YSign(direction));
+}
+
+float SnakeBase::GetPreviousHeadPositionX() const {
+  return Position(prev_head.x, prev_progress, XSign(prev_direction));
+}
+
+float SnakeBase::GetPreviousHeadPositionY() const {
+  return Position(prev_head.y, prev_progress, YSign(prev_direction));
 }
 
 void SnakeBase::UpdateBody(SDL_Point &current_head_cell, SDL_Point &prev_head_cell) {
+  // The previous head cell stays covered, it just becomes part of the body.
   body.push_back(prev_head_cell);
 
   if (!growing) {
-    body.erase(body.begin());
+    occupancy[CellIndex(body.front().x, body.front().y)]--;
+    changed_cells.push_back(body.front());
+    body.pop_front();
   } else {
     growing = false;
     size++;
   }
 
-  for (auto const &item : body) {
-    if (current_head_cell.x == item.x && current_head_cell.y == item.y) {
-      alive = false;
-    }
+  // With the tail released, any other segment on the new head cell means the
+  // snake ran into itself.
+  changed_cells.push_back(current_head_cell);
+  if (++occupancy[CellIndex(current_head_cell.x, current_head_cell.y)] > 1) {
+    alive = false;
   }
 }
 
@@ -56,14 +120,35 @@ void SnakeBase::GrowBody() {
   growing = true; 
 }
 
+void SnakeBase::PlaceHead(int x, int y) {
+  occupancy[CellIndex(head.x, head.y)]--;
+  changed_cells.push_back(head);
+  head = {x, y};
+  progress = 0;
+  BeginTick();
+  occupancy[CellIndex(head.x, head.y)]++;
+  changed_cells.push_back(head);
+}
+
 bool SnakeBase::SnakeCell(int x, int y) const {
-  if (x == static_cast<int>(head_x) && y == static_cast<int>(head_y)) {
-    return true;
+  if (x < 0 || x >= grid_width || y < 0 || y >= grid_height) {
+    return false;
   }
-  for (auto const &item : body) {
-    if (x == item.x && y == item.y) {
-      return true;
-    }
+  return occupancy[CellIndex(x, y)] != 0;
+}
+
+std::uint64_t SnakeBase::StateHash(std::uint64_t hash) const {
+  hash = HashValue(hash, head.x);
+  hash = HashValue(hash, head.y);
+  hash = HashValue(hash, progress);
+  hash = HashValue(hash, speed);
+  hash = HashValue(hash, static_cast<int>(direction));
+  hash = HashValue(hash, size);
+  hash = HashValue(hash, alive);
+  hash = HashValue(hash, growing);
+  for (auto const &point : body) {
+    hash = HashValue(hash, point.x);
+    hash = HashValue(hash, point.y);
   }
-  return false;
+  return hash;
 }
@@ -3,41 +3,93 @@
 
 #include <vector>
 #include <memory>
-#include "SDL.h"
+#include <cstdint>
+#include "sdl_types.h"
+#include "ring_buffer.h"
 
+// The head sits in an integer cell and moves by fixed-point progress: each
+// tick adds the speed to |progress|, and once it reaches a whole cell the
+// head steps into the neighbouring cell in the current direction. Integer
+// arithmetic makes cell crossings exact and reproducible, where float
+// positions drifted with every speed increment.
 class SnakeBase {
  public:
   enum class Direction { kUp, kDown, kLeft, kRight };
 
+  // Progress per cell. Speeds are in the same units per tick at
+  // kBaseTicksPerSecond.
+  static constexpr std::int32_t kCellUnits = 10000;
+  static constexpr int kBaseTicksPerSecond = 60;
+
   SnakeBase(int grid_width, int grid_height);
   virtual ~SnakeBase() = default;
 
   virtual void Update() = 0;
   virtual void ChangeDirection(Direction input, Direction opposite);
+  static Direction Opposite(Direction direction);
 
   void GrowBody();
   bool SnakeCell(int x, int y) const;
   bool IsAlive() const { return alive; }
-  float GetHeadX() const { return head_x; }
-  float GetHeadY() const { return head_y; }
+  SDL_Point GetHeadCell() const { return head; }
+  // Progress toward the next cell in the current direction, in kCellUnits.
+  std::int32_t GetProgress() const { return progress; }
+  // Where the head is drawn, in cells: the head cell moved |progress| of the
+  // way toward the next one. May lie just outside the board at its edges.
+  float GetHeadPositionX() const;
+  float GetHeadPositionY() const;
+  // The same at the start of the current tick, for drawing the head part
+  // way between two ticks.
+  float GetPreviousHeadPositionX() const;
+  float GetPreviousHeadPositionY() const;
+  // Call before Update(); remembers where the head starts the tick.
+  void BeginTick() {
+    prev_head = head;
+    prev_progress = progress;
+    prev_direction = direction;
+  }
+  // Scales every move to a game running at |rate| ticks per second, so it
+  // keeps the same pace in real time as one at kBaseTicksPerSecond.
+  void SetTicksPerSecond(int rate) { ticks_per_second = rate; }
   int GetSize() const { return size; }
-  const std::vector<SDL_Point>& GetBody() const { return body; }
+  const RingBuffer<SDL_Point>& GetBody() const { return body; }
+  // Per-cell segment counts, indexed by y * grid_width + x.
+  const std::vector<std::uint16_t>& GetOccupancy() const { return occupancy; }
+  // Cells the head entered or the tail left since the last
+  // ClearChangedCells(), for planners that track the board incrementally.
+  const std::vector<SDL_Point>& GetChangedCells() const { return changed_cells; }
+  void ClearChangedCells() { changed_cells.clear(); }
+  // Folds everything that affects future movement into |hash|.
+  std::uint64_t StateHash(std::uint64_t hash) const;
   
   Direction direction = Direction::kUp;
-  float speed{0.1f};
+  // In kCellUnits per tick at kBaseTicksPerSecond. A tick never moves the
+  // head more than one cell, however fast the snake gets.
+  std::int32_t speed{kCellUnits / 10};
   int size{1};
   bool alive{true};
 
  protected:
-  void UpdateHead();
+  // Advances the head by one tick. Returns true if it entered a new cell.
+  bool UpdateHead();
   void UpdateBody(SDL_Point &current_cell, SDL_Point &prev_cell);
-  
-  float head_x;
-  float head_y;
-  std::vector<SDL_Point> body;
-  bool growing{false};
+  void PlaceHead(int x, int y);
+  int CellIndex(int x, int y) const { return y * grid_width + x; }
+
   int grid_width;
   int grid_height;
+  SDL_Point head;
+  std::int32_t progress{0};
+  SDL_Point prev_head;
+  std::int32_t prev_progress{0};
+  Direction prev_direction{Direction::kUp};
+  int ticks_per_second{kBaseTicksPerSecond};
+  RingBuffer<SDL_Point> body;
+  bool growing{false};
+  // Number of snake segments (head included) covering each cell, indexed by
+  // CellIndex(). Kept in sync with head and body so SnakeCell() is one load.
+  std::vector<std::uint16_t> occupancy;
+  std::vector<SDL_Point> changed_cells;
 };
 
 #endif
@@ -0,0 +1,94 @@
+#include "software_renderer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Sets |count| pixels to |value|, four per store where SSE2 is available
+// (always, on x86-64).
+void FillPixels(std::uint32_t *pixels, int count, std::uint32_t value) {
+  int i = 0;
+#if defined(__SSE2__)
+  __m128i fill = _mm_set1_epi32(static_cast<int>(value));
+  for (; i + 16 <= count; i += 16) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), fill);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i + 4), fill);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i + 8), fill);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i + 12), fill);
+  }
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), fill);
+  }
+#endif
+  for (; i < count; ++i) {
+    pixels[i] = value;
+  }
+}
+
+}  // namespace
+
+SoftwareRenderer::SoftwareRenderer(VideoWriter &writer, std::size_t grid_width,
+                                   std::size_t grid_height)
+    : writer_(writer), view_(writer.Width(), writer.Height(), grid_width, grid_height) {
+  for (int colour = 0; colour < BoardView::kColourCount; ++colour) {
+    const SDL_Color &rgb = BoardView::kPalette[colour];
+    palette_[colour] = (static_cast<std::uint32_t>(rgb.r) << 16) |
+                       (static_cast<std::uint32_t>(rgb.g) << 8) | rgb.b;
+  }
+}
+
+bool SoftwareRenderer::Render(PlayerSnake const &player_snake,
+                              std::vector<std::shared_ptr<AISnake>> const &ai_snakes,
+                              SDL_Point const &food, std::vector<std::uint16_t> const &owners) {
+  view_.Update(player_snake, ai_snakes, food, owners);
+  Rasterize(writer_.BackBuffer());
+  return writer_.SubmitFrame();
+}
+
+// Every pixel row of a cell row is the same, so each cell row is drawn once
+// as runs of same-coloured cells and then copied down. Pixels past the last
+// cell keep the background colour, as the window's clear would. Head
+// markers go on top, as in Renderer.
+void SoftwareRenderer::Rasterize(std::uint32_t *pixels) const {
+  int width = writer_.Width();
+  int height = writer_.Height();
+  int cell_size = view_.CellSize();
+  int columns = view_.Columns();
+  const std::uint8_t *colours = view_.Colours().data();
+  std::uint32_t background = palette_[BoardView::kBackground];
+
+  int y = 0;
+  for (int row = 0; row < view_.Rows() && y < height; ++row) {
+    std::uint32_t *line = pixels + static_cast<std::size_t>(y) * width;
+    const std::uint8_t *cells = colours + static_cast<std::size_t>(row) * columns;
+    int x = 0;
+    int column = 0;
+    while (column < columns && x < width) {
+      int run_end = column + 1;
+      while (run_end < columns && cells[run_end] == cells[column]) run_end++;
+      int run_pixels = std::min((run_end - column) * cell_size, width - x);
+      FillPixels(line + x, run_pixels, palette_[cells[column]]);
+      x += run_pixels;
+      column = run_end;
+    }
+    FillPixels(line + x, width - x, background);
+
+    int line_count = std::min(cell_size, height - y);
+    for (int copy = 1; copy < line_count; ++copy) {
+      std::memcpy(line + static_cast<std::size_t>(copy) * width, line, width * sizeof(*line));
+    }
+    y += line_count;
+  }
+  FillPixels(pixels + static_cast<std::size_t>(y) * width, (height - y) * width, background);
+
+  for (const BoardView::HeadMarker &head : view_.Heads()) {
+    for (int row = head.rect.y; row < head.rect.y + head.rect.h; ++row) {
+      FillPixels(pixels + static_cast<std::size_t>(row) * width + head.rect.x, head.rect.w,
+                 palette_[head.colour]);
+    }
+  }
+}
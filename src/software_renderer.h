@@ -0,0 +1,37 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "sdl_types.h"
+#include "board_view.h"
+#include "player_snake.h"
+#include "ai_snake.h"
+#include "video_writer.h"
+
+// Draws the same frames as Renderer, from the same BoardView, into a CPU
+// pixel buffer and hands each one to a VideoWriter. Needs no display, GPU
+// or SDL video subsystem, so matches can be recorded on headless servers.
+class SoftwareRenderer {
+ public:
+  // Frames are |writer|'s size; the board is laid out as Renderer would lay
+  // it out in a window of that size.
+  SoftwareRenderer(VideoWriter &writer, std::size_t grid_width, std::size_t grid_height);
+
+  // Returns false once the writer has failed; see VideoWriter::SubmitFrame.
+  bool Render(PlayerSnake const &player_snake,
+              std::vector<std::shared_ptr<AISnake>> const &ai_snakes, SDL_Point const &food,
+              std::vector<std::uint16_t> const &owners);
+
+  BoardView &GetView() { return view_; }
+
+ private:
+  VideoWriter &writer_;
+  BoardView view_;
+  std::uint32_t palette_[BoardView::kColourCount];
+
+  void Rasterize(std::uint32_t *pixels) const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single-producer / single-consumer FIFO of fixed capacity. Each
+// side owns one index and only reads the other's, so a push or pop is one
+// acquire load, one copy and one release store. Capacity must be a power of
+// two; a push onto a full queue fails rather than blocking.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+ public:
+  // Producer side. Returns false if the queue is full.
+  bool TryPush(const T &value) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    slots_[tail & kMask] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false if the queue is empty.
+  bool TryPop(T &value) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = slots_[head & kMask];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  static constexpr std::size_t kMask = Capacity - 1;
+
+  std::array<T, Capacity> slots_{};
+  // On separate cache lines so the two sides do not false-share.
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// FNV-1a over raw bytes. Used for replay verification hashes, so it must only
+// see plain values (no padding, no pointers).
+constexpr std::uint64_t kStateHashSeed = 0xcbf29ce484222325ull;
+
+inline std::uint64_t HashBytes(std::uint64_t hash, const void *data, std::size_t size) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+template <typename T>
+std::uint64_t HashValue(std::uint64_t hash, const T &value) {
+  return HashBytes(hash, &value, sizeof(value));
+}
+
+#endif
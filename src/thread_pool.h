@@ -0,0 +1,41 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork-join jobs. Run() hands the same job to
+// every worker, with the calling thread doing worker 0's share, and returns
+// once all of them have finished. The threads live as long as the pool, so a
+// job costs a wake-up rather than a thread start.
+class ThreadPool {
+ public:
+  // |threads| workers including the caller; 0 means one per hardware thread.
+  explicit ThreadPool(int threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int Size() const { return static_cast<int>(threads_.size()) + 1; }
+  // Calls job(i) once for every worker index i in [0, Size()).
+  void Run(const std::function<void(int)> &job);
+
+ private:
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(int)> *job_{nullptr};
+  // Bumped for every job, so each worker runs it exactly once.
+  std::uint64_t generation_{0};
+  int running_{0};
+  bool stopping_{false};
+
+  void WorkerLoop(int index);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer hand-off of the latest value.
+// The producer fills WriteBuffer() and calls Publish(); the consumer calls
+// Acquire() and reads ReadBuffer(). Three slots mean neither side ever waits
+// for the other: the producer always owns one slot, the consumer owns one,
+// and the third holds the most recently published value. Intermediate values
+// the consumer never picked up are simply overwritten.
+template <typename T>
+class TripleBuffer {
+ public:
+  T &WriteBuffer() { return slots_[back_]; }
+
+  void Publish() {
+    back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndexMask;
+  }
+
+  // Takes the latest published value, if there is one the consumer has not
+  // seen yet. Returns false (keeping the previous ReadBuffer()) otherwise.
+  bool Acquire() {
+    if (!(middle_.load(std::memory_order_relaxed) & kFresh)) {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+
+  const T &ReadBuffer() const { return slots_[front_]; }
+
+ private:
+  static constexpr int kIndexMask = 3;
+  static constexpr int kFresh = 4;
+
+  std::array<T, 3> slots_;
+  std::atomic<int> middle_{1};
+  int back_{0};
+  int front_{2};
+};
+
+#endif
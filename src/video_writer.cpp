@@ -0,0 +1,147 @@
+#include "video_writer.h"
+#include <iostream>
+
+namespace {
+
+// BT.601 studio-range conversion, as Y4M players expect by default.
+std::uint8_t LumaOf(int r, int g, int b) {
+  return static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+std::uint8_t BlueDiffOf(int r, int g, int b) {
+  return static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+std::uint8_t RedDiffOf(int r, int g, int b) {
+  return static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+}  // namespace
+
+VideoWriter::VideoWriter(int width, int height, int fps, Format format)
+    : width_(width), height_(height), fps_(fps), format_(format) {
+  std::size_t pixels = static_cast<std::size_t>(width) * height;
+  frames_[0].resize(pixels);
+  frames_[1].resize(pixels);
+  encoded_.resize(pixels * 3);
+}
+
+VideoWriter::~VideoWriter() { Close(); }
+
+bool VideoWriter::Open(const std::string &path) {
+  if (path == "-") {
+    file_ = stdout;
+    owns_file_ = false;
+  } else {
+    file_ = std::fopen(path.c_str(), "wb");
+    owns_file_ = true;
+  }
+  if (!file_) {
+    std::cerr << "Could not open " << path << " for writing\n";
+    return false;
+  }
+
+  if (format_ == Format::kY4M) {
+    std::fprintf(file_, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width_, height_, fps_);
+  }
+  closing_ = false;
+  failed_ = false;
+  thread_ = std::thread(&VideoWriter::WriterLoop, this);
+  return true;
+}
+
+bool VideoWriter::Close() {
+  if (!thread_.joinable()) {
+    return !failed_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+
+  if (std::fflush(file_) != 0) failed_ = true;
+  if (owns_file_ && std::fclose(file_) != 0) failed_ = true;
+  file_ = nullptr;
+  if (failed_) {
+    std::cerr << "Writing video frames failed\n";
+  }
+  return !failed_;
+}
+
+bool VideoWriter::SubmitFrame() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (pending_ >= 0) {
+    auto start = std::chrono::steady_clock::now();
+    cv_.wait(lock, [this] { return pending_ < 0; });
+    stall_time_ += std::chrono::steady_clock::now() - start;
+  }
+  if (failed_) {
+    return false;
+  }
+  pending_ = back_;
+  back_ ^= 1;
+  lock.unlock();
+  cv_.notify_all();
+  return true;
+}
+
+std::uint64_t VideoWriter::GetFramesWritten() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frames_written_;
+}
+
+// Keeps the pending buffer marked busy while it is encoded and written, so
+// SubmitFrame cannot hand the same buffer back to the caller.
+void VideoWriter::WriterLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return pending_ >= 0 || closing_; });
+    if (pending_ < 0) {
+      return;
+    }
+    const std::uint32_t *pixels = frames_[pending_].data();
+    lock.unlock();
+
+    Encode(pixels);
+    bool ok = true;
+    if (format_ == Format::kY4M) {
+      ok = std::fputs("FRAME\n", file_) >= 0;
+    } else {
+      ok = std::fprintf(file_, "P6\n%d %d\n255\n", width_, height_) > 0;
+    }
+    ok = ok && std::fwrite(encoded_.data(), 1, encoded_.size(), file_) == encoded_.size();
+
+    lock.lock();
+    failed_ |= !ok;
+    if (ok) frames_written_++;
+    pending_ = -1;
+    cv_.notify_all();
+  }
+}
+
+// Y4M: full-resolution Y, U and V planes. PPM: interleaved RGB.
+void VideoWriter::Encode(const std::uint32_t *pixels) {
+  std::size_t count = static_cast<std::size_t>(width_) * height_;
+  std::uint8_t *out = encoded_.data();
+  if (format_ == Format::kPPM) {
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint32_t pixel = pixels[i];
+      out[3 * i] = static_cast<std::uint8_t>(pixel >> 16);
+      out[3 * i + 1] = static_cast<std::uint8_t>(pixel >> 8);
+      out[3 * i + 2] = static_cast<std::uint8_t>(pixel);
+    }
+    return;
+  }
+
+  std::uint8_t *y_plane = out;
+  std::uint8_t *u_plane = out + count;
+  std::uint8_t *v_plane = out + 2 * count;
+  for (std::size_t i = 0; i < count; ++i) {
+    int r = (pixels[i] >> 16) & 0xFF;
+    int g = (pixels[i] >> 8) & 0xFF;
+    int b = pixels[i] & 0xFF;
+    y_plane[i] = LumaOf(r, g, b);
+    u_plane[i] = BlueDiffOf(r, g, b);
+    v_plane[i] = RedDiffOf(r, g, b);
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef VIDEO_WRITER_H
+#define VIDEO_WRITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams frames to a file or pipe from a background thread. Frames are
+// double buffered: the caller draws the next frame into one buffer while the
+// thread converts and writes the other, so file or pipe latency overlaps
+// with the simulation instead of adding to it. The caller only waits when
+// the writer falls a whole frame behind.
+//
+// Y4M is written as uncompressed 4:4:4 BT.601 and PPM as a stream of P6
+// images; both can be piped straight into ffmpeg.
+class VideoWriter {
+ public:
+  enum class Format { kY4M, kPPM };
+
+  VideoWriter(int width, int height, int fps, Format format);
+  ~VideoWriter();
+
+  // Opens |path| ("-" for stdout) and starts the writer thread. Returns
+  // false if the file could not be opened.
+  bool Open(const std::string &path);
+  // Writes any queued frame, stops the thread and closes the file. Returns
+  // false if any write failed.
+  bool Close();
+
+  // Buffer for the next frame: width * height pixels, 0x00RRGGBB, row-major.
+  // Valid until SubmitFrame().
+  std::uint32_t *BackBuffer() { return frames_[back_].data(); }
+  // Queues the back buffer for writing. Returns false, and drops the frame,
+  // once an earlier write has failed (disk full, closed pipe); later frames
+  // would be lost as well, so the caller should stop drawing them.
+  bool SubmitFrame();
+
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+  // Frames written successfully.
+  std::uint64_t GetFramesWritten() const;
+  // Total time SubmitFrame spent waiting for the writer thread.
+  std::chrono::nanoseconds GetStallTime() const { return stall_time_; }
+
+ private:
+  int width_;
+  int height_;
+  int fps_;
+  Format format_;
+  std::FILE *file_{nullptr};
+  bool owns_file_{false};
+
+  std::vector<std::uint32_t> frames_[2];
+  int back_{0};
+  // Encoded bytes of one frame, only touched by the writer thread.
+  std::vector<std::uint8_t> encoded_;
+
+  std::thread thread_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  // Buffer handed to the writer thread, or -1 while it is idle.
+  int pending_{-1};
+  bool closing_{false};
+  bool failed_{false};
+  std::uint64_t frames_written_{0};
+  std::chrono::nanoseconds stall_time_{0};
+
+  void WriterLoop();
+  void Encode(const std::uint32_t *pixels);
+};
+
+#endif